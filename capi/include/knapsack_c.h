@@ -0,0 +1,108 @@
+#ifndef FHAMONIC_KNAPSACK_C_H
+#define FHAMONIC_KNAPSACK_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifdef KNAPSACK_C_BUILD
+#define KNAPSACK_C_API __declspec(dllexport)
+#else
+#define KNAPSACK_C_API __declspec(dllimport)
+#endif
+#else
+#define KNAPSACK_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Allocation failures terminate the program, as in the C++ solvers. */
+typedef enum {
+    KNAPSACK_OK = 0,
+    /* the timeout expired, the solution is the best one found */
+    KNAPSACK_TIMEOUT = 1,
+    KNAPSACK_INVALID_ARGUMENT = 2
+} knapsack_status;
+
+/* Counters are left to zero unless the library is built with
+   ENABLE_STATISTICS. */
+typedef struct {
+    uint64_t nb_nodes;
+    uint64_t nb_pruned_nodes;
+    uint64_t max_depth;
+    uint64_t nb_incumbent_updates;
+    int64_t preprocessing_time_ns;
+    int64_t time_to_first_incumbent_ns;
+    int64_t time_to_best_incumbent_ns;
+    int64_t solve_time_ns;
+} knapsack_bnb_statistics;
+
+/* A context owns a memory pool from which the branch and bound solvers
+   allocate, so that successive calls with the same context reuse the same
+   memory. A context must not be used by concurrent calls. Every function
+   accepts a NULL context, in which case the global heap is used. */
+typedef struct knapsack_context knapsack_context;
+
+KNAPSACK_C_API knapsack_context * knapsack_context_create(void);
+KNAPSACK_C_API void knapsack_context_destroy(knapsack_context * context);
+
+/* 0-1 knapsack branch and bound. 'values' and 'costs' hold 'nb_items'
+   entries, 'solution' must have room for 'nb_items' indices and receives the
+   indices of the taken items, their number is written to 'solution_size'.
+   A timeout of 0 waits for the search to complete. 'statistics' may be
+   NULL. */
+KNAPSACK_C_API knapsack_status knapsack_bnb_i32(
+    knapsack_context * context, const int32_t * values, const int32_t * costs,
+    size_t nb_items, int32_t budget, double timeout_s, uint32_t * solution,
+    size_t * solution_size, knapsack_bnb_statistics * statistics);
+KNAPSACK_C_API knapsack_status knapsack_bnb_i64(
+    knapsack_context * context, const int64_t * values, const int64_t * costs,
+    size_t nb_items, int64_t budget, double timeout_s, uint32_t * solution,
+    size_t * solution_size, knapsack_bnb_statistics * statistics);
+KNAPSACK_C_API knapsack_status knapsack_bnb_f64(
+    knapsack_context * context, const double * values, const double * costs,
+    size_t nb_items, double budget, double timeout_s, uint32_t * solution,
+    size_t * solution_size, knapsack_bnb_statistics * statistics);
+
+/* Unbounded knapsack branch and bound, 'counts' must have room for
+   'nb_items' entries and receives the number of times each taken item is
+   taken. The costs must be positive, otherwise KNAPSACK_INVALID_ARGUMENT is
+   returned. */
+KNAPSACK_C_API knapsack_status unbounded_knapsack_bnb_i32(
+    knapsack_context * context, const int32_t * values, const int32_t * costs,
+    size_t nb_items, int32_t budget, double timeout_s, uint32_t * solution,
+    uint64_t * counts, size_t * solution_size,
+    knapsack_bnb_statistics * statistics);
+KNAPSACK_C_API knapsack_status unbounded_knapsack_bnb_i64(
+    knapsack_context * context, const int64_t * values, const int64_t * costs,
+    size_t nb_items, int64_t budget, double timeout_s, uint32_t * solution,
+    uint64_t * counts, size_t * solution_size,
+    knapsack_bnb_statistics * statistics);
+KNAPSACK_C_API knapsack_status unbounded_knapsack_bnb_f64(
+    knapsack_context * context, const double * values, const double * costs,
+    size_t nb_items, double budget, double timeout_s, uint32_t * solution,
+    uint64_t * counts, size_t * solution_size,
+    knapsack_bnb_statistics * statistics);
+
+/* 0-1 knapsack dynamic programming for integer costs, its table takes
+   (nb_items + 1) * (budget + 1) entries and is allocated at each call.
+   KNAPSACK_INVALID_ARGUMENT is returned if a cost or the budget is negative
+   or if the table would take 2^28 entries or more. */
+KNAPSACK_C_API knapsack_status knapsack_dp_i32(const int32_t * values,
+                                               const int32_t * costs,
+                                               size_t nb_items, int32_t budget,
+                                               uint32_t * solution,
+                                               size_t * solution_size);
+KNAPSACK_C_API knapsack_status knapsack_dp_i64(const int64_t * values,
+                                               const int64_t * costs,
+                                               size_t nb_items, int64_t budget,
+                                               uint32_t * solution,
+                                               size_t * solution_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FHAMONIC_KNAPSACK_C_H */
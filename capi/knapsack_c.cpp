@@ -0,0 +1,238 @@
+#include "knapsack_c.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <ranges>
+#include <span>
+
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+#include "knapsack/unbounded_knapsack_bnb.hpp"
+
+namespace knapsack = fhamonic::knapsack;
+
+struct knapsack_context {
+    std::pmr::unsynchronized_pool_resource resource;
+};
+
+namespace {
+
+std::pmr::memory_resource * memory_resource(knapsack_context * context) {
+    return context ? &context->resource : std::pmr::get_default_resource();
+}
+
+// The items are the indices of the arrays entries
+template <typename V, typename C>
+struct array_instance {
+    const V * values;
+    const C * costs;
+    std::size_t nb_items;
+
+    auto items() const noexcept {
+        return std::views::iota(std::size_t{0}, nb_items);
+    }
+    auto value_map() const noexcept {
+        return [values = values](const std::size_t i) { return values[i]; };
+    }
+    auto cost_map() const noexcept {
+        return [costs = costs](const std::size_t i) { return costs[i]; };
+    }
+    // Solutions are written as uint32_t indices
+    bool valid() const noexcept {
+        return nb_items == 0 || (values && costs && nb_items <= UINT32_MAX);
+    }
+    // NaN costs are not positive
+    bool positive_costs() const noexcept {
+        return std::ranges::all_of(std::span(costs, nb_items),
+                                   [](const C cost) { return cost > 0; });
+    }
+    bool non_negative_costs() const noexcept {
+        return std::ranges::all_of(std::span(costs, nb_items),
+                                   [](const C cost) { return cost >= 0; });
+    }
+};
+
+// Larger dynamic programming tables are refused, as by the daemon
+constexpr std::size_t max_nb_dp_cells = std::size_t{1} << 28;
+
+void write_statistics(const knapsack::bnb_statistics & s,
+                      knapsack_bnb_statistics * statistics) noexcept {
+    if(!statistics) return;
+    *statistics = {s.nb_nodes,
+                   s.nb_pruned_nodes,
+                   s.max_depth,
+                   s.nb_incumbent_updates,
+                   s.preprocessing_time.count(),
+                   s.time_to_first_incumbent.count(),
+                   s.time_to_best_incumbent.count(),
+                   s.solve_time.count()};
+}
+
+// The search polls the deadline itself, a call starts no thread
+template <typename S>
+bool solve_within(S & solver, const double timeout_s) noexcept {
+    if(timeout_s == 0) return solver.solve(knapsack::never_stop_token{});
+    return solver.solve(knapsack::deadline_stop_token(
+        std::chrono::duration<double>(timeout_s)));
+}
+
+template <typename V, typename C>
+knapsack_status solve_bnb(knapsack_context * context, const V * values,
+                          const C * costs, const std::size_t nb_items,
+                          const C budget, const double timeout_s,
+                          std::uint32_t * solution,
+                          std::size_t * solution_size,
+                          knapsack_bnb_statistics * statistics) noexcept {
+    const array_instance<V, C> instance{values, costs, nb_items};
+    if(!instance.valid() || (nb_items > 0 && !solution) || !solution_size ||
+       !(timeout_s >= 0))
+        return KNAPSACK_INVALID_ARGUMENT;
+    auto solver = knapsack::knapsack_bnb(
+        budget, instance.items(), instance.value_map(),
+        instance.cost_map(), memory_resource(context));
+    const bool completed = solve_within(solver, timeout_s);
+    std::size_t size = 0;
+    for(const std::size_t i : solver.solution())
+        solution[size++] = static_cast<std::uint32_t>(i);
+    *solution_size = size;
+    write_statistics(solver.statistics(), statistics);
+    return completed ? KNAPSACK_OK : KNAPSACK_TIMEOUT;
+}
+
+template <typename V, typename C>
+knapsack_status solve_unbounded_bnb(
+    knapsack_context * context, const V * values, const C * costs,
+    const std::size_t nb_items, const C budget, const double timeout_s,
+    std::uint32_t * solution, std::uint64_t * counts,
+    std::size_t * solution_size,
+    knapsack_bnb_statistics * statistics) noexcept {
+    const array_instance<V, C> instance{values, costs, nb_items};
+    // an item of cost 0 could be taken infinitely many times
+    if(!instance.valid() || (nb_items > 0 && (!solution || !counts)) ||
+       !solution_size || !(timeout_s >= 0) || !instance.positive_costs())
+        return KNAPSACK_INVALID_ARGUMENT;
+    auto solver = knapsack::unbounded_knapsack_bnb(
+        budget, instance.items(), instance.value_map(),
+        instance.cost_map(), memory_resource(context));
+    const bool completed = solve_within(solver, timeout_s);
+    std::size_t size = 0;
+    for(auto && [i, count] : solver.solution()) {
+        solution[size] = static_cast<std::uint32_t>(i);
+        counts[size++] = static_cast<std::uint64_t>(count);
+    }
+    *solution_size = size;
+    write_statistics(solver.statistics(), statistics);
+    return completed ? KNAPSACK_OK : KNAPSACK_TIMEOUT;
+}
+
+template <typename V, typename C>
+knapsack_status solve_dp(const V * values, const C * costs,
+                         const std::size_t nb_items, const C budget,
+                         std::uint32_t * solution,
+                         std::size_t * solution_size) noexcept {
+    const array_instance<V, C> instance{values, costs, nb_items};
+    if(!instance.valid() || (nb_items > 0 && !solution) || !solution_size ||
+       budget < 0 ||
+       static_cast<std::size_t>(budget) >= max_nb_dp_cells / (nb_items + 1) ||
+       !instance.non_negative_costs())
+        return KNAPSACK_INVALID_ARGUMENT;
+    auto solver = knapsack::knapsack_dp(budget, instance.items(),
+                                        instance.value_map(),
+                                        instance.cost_map());
+    solver.solve();
+    std::size_t size = 0;
+    for(const std::size_t i : solver.solution())
+        solution[size++] = static_cast<std::uint32_t>(i);
+    *solution_size = size;
+    return KNAPSACK_OK;
+}
+
+}  // namespace
+
+extern "C" {
+
+knapsack_context * knapsack_context_create(void) {
+    return new(std::nothrow) knapsack_context;
+}
+
+void knapsack_context_destroy(knapsack_context * context) { delete context; }
+
+knapsack_status knapsack_bnb_i32(knapsack_context * context,
+                                 const int32_t * values, const int32_t * costs,
+                                 size_t nb_items, int32_t budget,
+                                 double timeout_s, uint32_t * solution,
+                                 size_t * solution_size,
+                                 knapsack_bnb_statistics * statistics) {
+    return solve_bnb(context, values, costs, nb_items, budget, timeout_s,
+                     solution, solution_size, statistics);
+}
+
+knapsack_status knapsack_bnb_i64(knapsack_context * context,
+                                 const int64_t * values, const int64_t * costs,
+                                 size_t nb_items, int64_t budget,
+                                 double timeout_s, uint32_t * solution,
+                                 size_t * solution_size,
+                                 knapsack_bnb_statistics * statistics) {
+    return solve_bnb(context, values, costs, nb_items, budget, timeout_s,
+                     solution, solution_size, statistics);
+}
+
+knapsack_status knapsack_bnb_f64(knapsack_context * context,
+                                 const double * values, const double * costs,
+                                 size_t nb_items, double budget,
+                                 double timeout_s, uint32_t * solution,
+                                 size_t * solution_size,
+                                 knapsack_bnb_statistics * statistics) {
+    return solve_bnb(context, values, costs, nb_items, budget, timeout_s,
+                     solution, solution_size, statistics);
+}
+
+knapsack_status unbounded_knapsack_bnb_i32(
+    knapsack_context * context, const int32_t * values, const int32_t * costs,
+    size_t nb_items, int32_t budget, double timeout_s, uint32_t * solution,
+    uint64_t * counts, size_t * solution_size,
+    knapsack_bnb_statistics * statistics) {
+    return solve_unbounded_bnb(context, values, costs, nb_items, budget,
+                               timeout_s, solution, counts, solution_size,
+                               statistics);
+}
+
+knapsack_status unbounded_knapsack_bnb_i64(
+    knapsack_context * context, const int64_t * values, const int64_t * costs,
+    size_t nb_items, int64_t budget, double timeout_s, uint32_t * solution,
+    uint64_t * counts, size_t * solution_size,
+    knapsack_bnb_statistics * statistics) {
+    return solve_unbounded_bnb(context, values, costs, nb_items, budget,
+                               timeout_s, solution, counts, solution_size,
+                               statistics);
+}
+
+knapsack_status unbounded_knapsack_bnb_f64(
+    knapsack_context * context, const double * values, const double * costs,
+    size_t nb_items, double budget, double timeout_s, uint32_t * solution,
+    uint64_t * counts, size_t * solution_size,
+    knapsack_bnb_statistics * statistics) {
+    return solve_unbounded_bnb(context, values, costs, nb_items, budget,
+                               timeout_s, solution, counts, solution_size,
+                               statistics);
+}
+
+knapsack_status knapsack_dp_i32(const int32_t * values, const int32_t * costs,
+                                size_t nb_items, int32_t budget,
+                                uint32_t * solution, size_t * solution_size) {
+    return solve_dp(values, costs, nb_items, budget, solution, solution_size);
+}
+
+knapsack_status knapsack_dp_i64(const int64_t * values, const int64_t * costs,
+                                size_t nb_items, int64_t budget,
+                                uint32_t * solution, size_t * solution_size) {
+    return solve_dp(values, costs, nb_items, budget, solution, solution_size);
+}
+
+}  // extern "C"
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/solve.hpp"
+#include "knapsack/unbounded_knapsack_bnb.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// Reads line delimited requests from stdin or from the connections to a Unix
+// domain socket and solves them on a pool of worker threads. A request is
+//
+//     <id> <solver> <budget> <n> <value_1> <cost_1> ... <value_n> <cost_n>
+//
+// where <id> is made of letters, digits, '_' and '-', <solver> is one of bnb,
+// best_first, unbounded, dp or auto, and its response is a JSON line carrying
+// the same id. Responses are written as soon as they are solved, so they may
+// come out of order. With --timeout, the branch and bound searches stop after
+// that many seconds and their best solution is reported as not optimal.
+
+// Solution values are summed as in the solvers, which may be wider than the
+// integers that std::ostream prints. The values of the 0-1 solutions and the
+// products of the values and counts of the unbounded ones, which cost at
+// most the budget, are below 2^126.
+using value_sum = Knapsack::accumulator_t<std::int64_t>;
+
+void write_value(std::ostream & os, const value_sum value) {
+    constexpr std::int64_t e18 = 1000000000000000000;
+    if(value < 0) {
+        os << '-';
+        write_value(os, -value);
+        return;
+    }
+    if(value < e18) {
+        os << static_cast<std::int64_t>(value);
+        return;
+    }
+    write_value(os, value / e18);
+    os << std::setw(18) << std::setfill('0')
+       << static_cast<std::int64_t>(value % e18) << std::setfill(' ');
+}
+
+// A file descriptor shared by the requests read from it, closed once the
+// last response is written.
+class connection {
+private:
+    int _fd;
+    std::mutex _mutex;
+
+public:
+    explicit connection(int fd) : _fd(fd) {}
+    ~connection() {
+        if(_fd > STDOUT_FILENO) ::close(_fd);
+    }
+
+    void write_line(const std::string & line) {
+        std::lock_guard lock(_mutex);
+        std::size_t written = 0;
+        while(written < line.size()) {
+            const ssize_t n =
+                ::write(_fd, line.data() + written, line.size() - written);
+            if(n <= 0) return;
+            written += static_cast<std::size_t>(n);
+        }
+    }
+};
+
+struct request {
+    std::shared_ptr<connection> output;
+    std::string line;
+};
+
+// Requests queue, the readers wait while it holds more than max_size
+// requests so that a fast client cannot exhaust the memory.
+class request_queue {
+private:
+    std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+    std::deque<request> _requests;
+    std::size_t _max_size;
+    bool _closed;
+
+public:
+    explicit request_queue(std::size_t max_size)
+        : _max_size(max_size), _closed(false) {}
+
+    void push(request && r) {
+        std::unique_lock lock(_mutex);
+        _not_full.wait(lock, [this] { return _requests.size() < _max_size; });
+        _requests.push_back(std::move(r));
+        _not_empty.notify_one();
+    }
+
+    // Returns nothing once the queue is closed and empty
+    std::optional<request> pop() {
+        std::unique_lock lock(_mutex);
+        _not_empty.wait(lock, [this] { return _closed || !_requests.empty(); });
+        if(_requests.empty()) return std::nullopt;
+        std::optional<request> r = std::move(_requests.front());
+        _requests.pop_front();
+        _not_full.notify_one();
+        return r;
+    }
+
+    void close() {
+        std::lock_guard lock(_mutex);
+        _closed = true;
+        _not_empty.notify_all();
+    }
+};
+
+class line_reader {
+private:
+    int _fd;
+    std::string _buffer;
+    std::size_t _begin;
+
+public:
+    explicit line_reader(int fd) : _fd(fd), _begin(0) {}
+
+    bool next(std::string & line) {
+        for(;;) {
+            const std::size_t end = _buffer.find('\n', _begin);
+            if(end != std::string::npos) {
+                line.assign(_buffer, _begin, end - _begin);
+                _begin = end + 1;
+                return true;
+            }
+            _buffer.erase(0, _begin);
+            _begin = 0;
+            char chunk[1 << 16];
+            const ssize_t n = ::read(_fd, chunk, sizeof(chunk));
+            if(n <= 0) {
+                line.swap(_buffer);
+                _buffer.clear();
+                return !line.empty();
+            }
+            _buffer.append(chunk, static_cast<std::size_t>(n));
+        }
+    }
+};
+
+// A worker keeps its instance buffers and its memory pool from one request
+// to the next, so that a warm worker barely allocates.
+class worker {
+private:
+    // Larger dynamic programming tables are refused
+    static constexpr std::size_t max_nb_dp_cells = std::size_t{1} << 28;
+
+    std::chrono::duration<double> _timeout;
+    std::pmr::unsynchronized_pool_resource _resource;
+    std::vector<std::int64_t> _values;
+    std::vector<std::int64_t> _costs;
+    std::ostringstream _response;
+
+    static bool parse(std::string_view & s, auto & x) {
+        while(!s.empty() && s.front() == ' ') s.remove_prefix(1);
+        const auto [end, error] =
+            std::from_chars(s.data(), s.data() + s.size(), x);
+        if(error != std::errc{}) return false;
+        s.remove_prefix(static_cast<std::size_t>(end - s.data()));
+        return true;
+    }
+
+    // The ids are written unescaped in the JSON responses
+    static bool valid_id(const std::string_view id) {
+        return !id.empty() && std::ranges::all_of(id, [](const char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                   (c >= '0' && c <= '9') || c == '_' || c == '-';
+        });
+    }
+
+    static std::string_view next_word(std::string_view & s) {
+        while(!s.empty() && s.front() == ' ') s.remove_prefix(1);
+        const std::size_t end = std::min(s.find(' '), s.size());
+        const std::string_view word = s.substr(0, end);
+        s.remove_prefix(end);
+        return word;
+    }
+
+    template <typename S>
+    void write_solution(const S & solution) {
+        value_sum value = 0;
+        _response << ",\"solution\":[";
+        bool first = true;
+        for(const std::size_t i : solution) {
+            _response << (first ? "" : ",") << i;
+            value += _values[i];
+            first = false;
+        }
+        _response << "],\"value\":";
+        write_value(_response, value);
+    }
+
+    void solve(std::string_view solver, const std::int64_t budget) {
+        const auto items = std::views::iota(std::size_t{0}, _values.size());
+        const auto value_map = [this](const std::size_t i) {
+            return _values[i];
+        };
+        const auto cost_map = [this](const std::size_t i) {
+            return _costs[i];
+        };
+        const auto start_time = std::chrono::steady_clock::now();
+        auto write_time = [this, start_time] {
+            _response << ",\"time_us\":"
+                      << std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+        };
+        auto write_statistics = [this](const auto & statistics) {
+            if constexpr(Knapsack::enable_statistics) {
+                _response << ",\"statistics\":";
+                Knapsack::write_json(_response, statistics);
+            }
+        };
+        auto write_optimal = [this](const bool optimal) {
+            _response << ",\"optimal\":" << (optimal ? "true" : "false");
+        };
+        // the dynamic programs selected by auto are bounded in size, only
+        // the branch and bound is subject to the timeout
+        if(solver == "auto" &&
+           Knapsack::select_solver(budget, items, value_map, cost_map) ==
+               Knapsack::solver_kind::branch_and_bound)
+            solver = "bnb";
+        if(solver == "bnb" || solver == "best_first") {
+            auto knapsack = Knapsack::knapsack_bnb(budget, items, value_map,
+                                                   cost_map, &_resource);
+            if(solver == "best_first")
+                knapsack.set_search_strategy(
+                    Knapsack::search_strategy::best_first);
+            const bool optimal = knapsack.solve(_timeout);
+            write_time();
+            write_optimal(optimal);
+            write_solution(knapsack.solution());
+            write_statistics(knapsack.statistics());
+        } else if(solver == "dp") {
+            auto knapsack =
+                Knapsack::knapsack_dp(budget, items, value_map, cost_map);
+            knapsack.solve();
+            write_time();
+            write_optimal(true);
+            write_solution(knapsack.solution());
+            write_statistics(knapsack.statistics());
+        } else if(solver == "auto") {
+            const auto solution =
+                Knapsack::solve(budget, items, value_map, cost_map);
+            write_time();
+            write_optimal(true);
+            write_solution(solution);
+        } else {
+            auto knapsack = Knapsack::unbounded_knapsack_bnb(
+                budget, items, value_map, cost_map, &_resource);
+            const bool optimal = knapsack.solve(_timeout);
+            write_time();
+            write_optimal(optimal);
+            value_sum value = 0;
+            _response << ",\"solution\":[";
+            bool first = true;
+            for(auto && [i, count] : knapsack.solution()) {
+                _response << (first ? "[" : ",[") << i << ',' << count << ']';
+                value += static_cast<value_sum>(_values[i]) *
+                         static_cast<value_sum>(count);
+                first = false;
+            }
+            _response << "],\"value\":";
+            write_value(_response, value);
+            write_statistics(knapsack.statistics());
+        }
+    }
+
+public:
+    // A timeout of zero lets the searches complete
+    explicit worker(const std::chrono::duration<double> timeout)
+        : _timeout(timeout) {}
+
+    void process(const request & r) {
+        std::string_view s = r.line;
+        const std::string_view id = next_word(s);
+        const std::string_view solver = next_word(s);
+        std::int64_t budget;
+        std::size_t nb_items;
+        _response.str("");
+        if(!valid_id(id)) {
+            _response << "{\"id\":null,\"error\":\"invalid id\"}\n";
+            r.output->write_line(_response.str());
+            return;
+        }
+        _response << "{\"id\":\"" << id << '"';
+        const bool unbounded = (solver == "unbounded");
+        // each item takes at least 4 characters, which bounds nb_items
+        bool valid = (unbounded || solver == "bnb" || solver == "best_first" ||
+                      solver == "dp" || solver == "auto") &&
+                     parse(s, budget) && parse(s, nb_items) && budget >= 0 &&
+                     nb_items <= s.size() / 4;
+        if(valid && solver == "dp")
+            valid = static_cast<std::size_t>(budget) <
+                    max_nb_dp_cells / (nb_items + 1);
+        if(valid) {
+            _values.resize(nb_items);
+            _costs.resize(nb_items);
+            for(std::size_t i = 0; valid && i < nb_items; ++i)
+                valid = parse(s, _values[i]) && parse(s, _costs[i]) &&
+                        _costs[i] >= (unbounded ? 1 : 0);
+        }
+        if(valid)
+            solve(solver, budget);
+        else
+            _response << ",\"error\":\"invalid request\"";
+        _response << "}\n";
+        r.output->write_line(_response.str());
+    }
+};
+
+void read_requests(const int fd, request_queue & queue) {
+    auto output = std::make_shared<connection>(
+        fd == STDIN_FILENO ? STDOUT_FILENO : fd);
+    line_reader reader(fd);
+    std::string line;
+    while(reader.next(line)) {
+        if(line.empty()) continue;
+        queue.push({output, std::move(line)});
+        line = std::string();
+    }
+}
+
+int main(int argc, const char * argv[]) {
+    std::size_t nb_threads = std::thread::hardware_concurrency();
+    const char * socket_path = nullptr;
+    double timeout_s = 0;
+    for(int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if(arg == "--threads" && i + 1 < argc) {
+            nb_threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if(arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if(arg == "--timeout" && i + 1 < argc) {
+            timeout_s = std::strtod(argv[++i], nullptr);
+        } else {
+            std::cerr << "usage : " << argv[0]
+                      << " [--threads <nb_threads>] [--socket <path>]"
+                         " [--timeout <seconds>]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if(!(timeout_s >= 0)) {
+        std::cerr << "the timeout must be non negative" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::chrono::duration<double> timeout(timeout_s);
+    nb_threads = std::max(nb_threads, std::size_t{1});
+    // a client closing its connection early must not kill the daemon
+    std::signal(SIGPIPE, SIG_IGN);
+
+    request_queue queue(4 * nb_threads);
+    std::vector<std::jthread> workers;
+    for(std::size_t t = 0; t < nb_threads; ++t)
+        workers.emplace_back([&queue, timeout] {
+            worker w(timeout);
+            while(std::optional<request> r = queue.pop()) w.process(*r);
+        });
+
+    if(socket_path == nullptr) {
+        read_requests(STDIN_FILENO, queue);
+        queue.close();
+        return EXIT_SUCCESS;
+    }
+
+    const int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(listen_fd < 0 ||
+       std::strlen(socket_path) >= sizeof(address.sun_path)) {
+        std::cerr << socket_path << ": invalid socket" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::strcpy(address.sun_path, socket_path);
+    ::unlink(socket_path);
+    if(::bind(listen_fd, reinterpret_cast<const sockaddr *>(&address),
+              sizeof(address)) < 0 ||
+       ::listen(listen_fd, SOMAXCONN) < 0) {
+        std::cerr << socket_path << ": " << std::strerror(errno) << std::endl;
+        return EXIT_FAILURE;
+    }
+    for(;;) {
+        const int fd = ::accept(listen_fd, nullptr, nullptr);
+        if(fd < 0) continue;
+        std::thread(read_requests, fd, std::ref(queue)).detach();
+    }
+}
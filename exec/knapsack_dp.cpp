@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 
@@ -38,12 +39,15 @@ int main(int argc, const char * argv[]) {
 
     int time_us = chrono.timeUs();
 
-    int solution_value = 0;
+    std::int64_t solution_value = 0;
     for(auto && i : knapsack.solution()) {     
         // std::cout << i.value << " " << i.cost << std::endl;
         solution_value += i.value;
     }
     std::cout << solution_value << " in " << time_us << " µs" << std::endl;
+    if constexpr(Knapsack::enable_statistics) {
+        Knapsack::write_json(std::cout, knapsack.statistics()) << std::endl;
+    }
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
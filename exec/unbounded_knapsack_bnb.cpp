@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 
@@ -6,6 +7,8 @@
 #include "utils/chrono.hpp"
 #include "utils/instance_parsers.hpp"
 
+namespace Knapsack = fhamonic::knapsack;
+
 int main(int argc, const char * argv[]) {
     if(argc < 2) {
         std::cerr << "input requiered : <knapsack_instance_file>" << std::endl;
@@ -23,7 +26,7 @@ int main(int argc, const char * argv[]) {
 
     Chrono chrono;
 
-    auto unbounded_knapsack = fhamonic::knapsack::unbounded_knapsack_bnb(
+    auto unbounded_knapsack = Knapsack::unbounded_knapsack_bnb(
         instance.getBudget(), instance.items(),
         [&instance](const Instance<int, int>::Item & i) {
             return i.value;
@@ -37,12 +40,16 @@ int main(int argc, const char * argv[]) {
 
     int time_us = chrono.timeUs();
 
-    int solution_value = 0;
+    std::int64_t solution_value = 0;
     for(auto && [i, nb] : unbounded_knapsack.solution()) {
         // std::cout << i.value << " " << i.cost << std::endl;
-        solution_value += i.value * nb;
+        solution_value += i.value * static_cast<std::int64_t>(nb);
     }
     std::cout << solution_value << " in " << time_us << " µs" << std::endl;
+    if constexpr(Knapsack::enable_statistics) {
+        Knapsack::write_json(std::cout, unbounded_knapsack.statistics())
+            << std::endl;
+    }
 
     return EXIT_SUCCESS;
 }
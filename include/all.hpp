@@ -1,8 +1,22 @@
 #ifndef FHAMONIC_KNAPSACK_ALL_HPP
 #define FHAMONIC_KNAPSACK_ALL_HPP
 
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/cardinality_knapsack_bnb.hpp"
+#include "knapsack/cardinality_knapsack_dp.hpp"
+#include "knapsack/conflict_knapsack_bnb.hpp"
+#include "knapsack/fractional_knapsack.hpp"
 #include "knapsack/knapsack_bnb.hpp"
 #include "knapsack/knapsack_dp.hpp"
+#include "knapsack/knapsack_mitm.hpp"
+#include "knapsack/knapsack_pareto_front.hpp"
+#include "knapsack/multiple_knapsack_bnb.hpp"
+#include "knapsack/quadratic_knapsack_bnb.hpp"
+#include "knapsack/solution_cache.hpp"
+#include "knapsack/solve.hpp"
+#include "knapsack/static_knapsack_bnb.hpp"
+#include "knapsack/stop_token.hpp"
+#include "knapsack/subset_sum_dp.hpp"
 #include "knapsack/unbounded_knapsack_bnb.hpp"
 
 #endif  // FHAMONIC_KNAPSACK_ALL_HPP
\ No newline at end of file
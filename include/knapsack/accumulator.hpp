@@ -0,0 +1,31 @@
+#ifndef FHAMONIC_KNAPSACK_ACCUMULATOR_HPP
+#define FHAMONIC_KNAPSACK_ACCUMULATOR_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+namespace fhamonic {
+namespace knapsack {
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 widest_int;
+#else
+typedef std::int64_t widest_int;
+#endif
+
+// Type in which the branch and bound solvers sum values. Integers narrower
+// than 64 bits are summed in 64 bits, that cost the same as 32-bit scalar
+// additions, and 64-bit integers in widest_int.
+template <typename V>
+using accumulator_t = std::conditional_t<
+    std::is_integral_v<V>,
+    std::conditional_t<
+        (sizeof(V) < sizeof(std::int64_t)),
+        std::conditional_t<std::is_signed_v<V>, std::int64_t, std::uint64_t>,
+        widest_int>,
+    V>;
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_ACCUMULATOR_HPP
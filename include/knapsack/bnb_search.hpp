@@ -0,0 +1,235 @@
+#ifndef FHAMONIC_KNAPSACK_BNB_SEARCH_HPP
+#define FHAMONIC_KNAPSACK_BNB_SEARCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Statistics updates of the branch and bound solvers, that compile to nothing
+// unless the statistics are enabled. The times are measured from the last
+// call to start_preprocessing() or start_solve().
+class bnb_statistics_recorder {
+private:
+    bnb_statistics _statistics;
+    std::chrono::steady_clock::time_point _start_time;
+
+    std::chrono::nanoseconds elapsed() const noexcept {
+        return std::chrono::steady_clock::now() - _start_time;
+    }
+
+public:
+    void start_preprocessing() noexcept {
+        if constexpr(enable_statistics)
+            _start_time = std::chrono::steady_clock::now();
+    }
+
+    void stop_preprocessing() noexcept {
+        if constexpr(enable_statistics)
+            _statistics.preprocessing_time = elapsed();
+    }
+
+    // Resets every statistic but the preprocessing time
+    void start_solve() noexcept {
+        if constexpr(enable_statistics) {
+            _statistics = bnb_statistics{
+                .preprocessing_time = _statistics.preprocessing_time};
+            _start_time = std::chrono::steady_clock::now();
+        }
+    }
+
+    void stop_solve() noexcept {
+        if constexpr(enable_statistics) _statistics.solve_time = elapsed();
+    }
+
+    void record_node(const std::size_t depth) noexcept {
+        if constexpr(enable_statistics) {
+            ++_statistics.nb_nodes;
+            _statistics.max_depth = std::max(_statistics.max_depth, depth);
+        }
+    }
+
+    void record_pruned_node() noexcept {
+        if constexpr(enable_statistics) ++_statistics.nb_pruned_nodes;
+    }
+
+    void record_incumbent() noexcept {
+        if constexpr(enable_statistics) {
+            _statistics.time_to_best_incumbent = elapsed();
+            if(_statistics.nb_incumbent_updates++ == 0)
+                _statistics.time_to_first_incumbent =
+                    _statistics.time_to_best_incumbent;
+        }
+    }
+
+    // Adds the nodes counted by the recorder of another search thread
+    void add_nodes(const bnb_statistics & s) noexcept {
+        if constexpr(enable_statistics) {
+            _statistics.nb_nodes += s.nb_nodes;
+            _statistics.nb_pruned_nodes += s.nb_pruned_nodes;
+            _statistics.max_depth =
+                std::max(_statistics.max_depth, s.max_depth);
+        }
+    }
+
+    const bnb_statistics & statistics() const noexcept { return _statistics; }
+};
+
+// Calls f(position, i, value, cost) for the items 'i' of positive value and
+// of cost at most 'budget', 'position' being their index in 'items', since
+// taking an item of non positive value never improves a solution. Returns
+// the number of items of 'items'.
+template <typename C, typename RI, typename VM, typename CM, typename F>
+std::size_t for_each_profitable_item(const C budget, const RI & items,
+                                     const VM & value_map, const CM & cost_map,
+                                     F && f) {
+    using V = std::invoke_result_t<VM, std::ranges::range_value_t<RI>>;
+    std::size_t nb_positions = 0;
+    for(auto && i : items) {
+        const std::size_t position = nb_positions++;
+        const V value = value_map(i);
+        if(value <= static_cast<V>(0)) continue;
+        const C cost = cost_map(i);
+        if(cost > budget) continue;
+        f(position, i, value, cost);
+    }
+    return nb_positions;
+}
+
+// Index in 'items' of an item given by its position, that must lie in
+// [0, nb_positions) where nb_positions is the number of items of 'items'
+template <std::integral P>
+std::size_t checked_position(const P position,
+                             const std::size_t nb_positions) {
+    if(std::cmp_less(position, 0) ||
+       std::cmp_greater_equal(position, nb_positions))
+        throw std::invalid_argument("item position out of range");
+    return static_cast<std::size_t>(position);
+}
+
+// Depth first search of the branch and bound solvers over items sorted so
+// that a node can be bounded from the next item it may take, its value, its
+// budget left and its number of taken items. The bound is a policy providing
+//  - can_take(nb_taken), whether a node of nb_taken items may take another,
+//  - next(it, nb_taken), the first item from 'it' on that a node of nb_taken
+//    items may take, or the end of the items,
+//  - take(it, nb_taken), called when a node of nb_taken items takes 'it',
+//  - prunable(it, value, budget_left, nb_taken, best_sol_value), whether the
+//    solutions taking items from 'it' on can be pruned.
+template <typename V, typename C, typename W>
+class sorted_items_dfs {
+public:
+    // Solutions are stored as the indices of their items in the sorted order
+    using item_index = std::uint32_t;
+    using value_cost_iterator =
+        typename std::pmr::vector<std::pair<V, C>>::const_iterator;
+
+private:
+    // Floating point sums drift when items are removed by subtraction, so
+    // the search states are saved on the way down and restored instead.
+    static constexpr bool restore_states =
+        std::floating_point<W> || std::floating_point<C>;
+
+    std::pmr::vector<item_index> _current_sol;
+    std::pmr::vector<std::pair<W, C>> _saved_states;
+
+public:
+    explicit sorted_items_dfs(std::pmr::memory_resource * resource)
+        : _current_sol(resource), _saved_states(resource) {}
+
+    // Preallocates the stacks for solutions of at most max_nb_taken items
+    void reserve(const std::size_t max_nb_taken) {
+        _current_sol.reserve(max_nb_taken);
+        if constexpr(restore_states) _saved_states.reserve(max_nb_taken);
+    }
+
+    // Explores the solutions extending 'prefix_sol' with items of [it, end),
+    // from a node of value 'current_sol_value' and budget 'budget_left'.
+    // Whenever one is better than best_sol_value, 'best_sol' is set to
+    // 'prefix_sol' followed by its items. Since the last incumbent, the
+    // first 'nb_synced' items of current_sol are unchanged, so only the
+    // following ones are copied. Returns false if 'stoken' stopped it.
+    template <typename B, typename ST>
+    bool search(const B & bound, const ST & stoken,
+                const value_cost_iterator begin, value_cost_iterator it,
+                const value_cost_iterator end, W current_sol_value,
+                C budget_left, W & best_sol_value,
+                const std::span<const item_index> prefix_sol,
+                std::pmr::vector<item_index> & best_sol,
+                bnb_statistics_recorder & statistics) noexcept {
+        auto & current_sol = _current_sol;
+        const auto nb_taken = [&] {
+            return prefix_sol.size() + current_sol.size();
+        };
+        std::size_t nb_synced = 0;
+        current_sol.resize(0);
+        if constexpr(restore_states) _saved_states.resize(0);
+        goto dive;
+    backtrack:
+        while(!current_sol.empty() && !stoken.stop_requested()) {
+            it = begin + current_sol.back();
+            if constexpr(restore_states) {
+                std::tie(current_sol_value, budget_left) = _saved_states.back();
+                _saved_states.pop_back();
+            } else {
+                current_sol_value -= it->first;
+                budget_left += it->second;
+            }
+            current_sol.pop_back();
+            nb_synced = std::min(nb_synced, current_sol.size());
+            ++it;
+        dive:
+            for(it = bound.next(it, nb_taken());
+                it < end && bound.can_take(nb_taken());
+                it = bound.next(it + 1, nb_taken())) {
+                if(budget_left < it->second) continue;
+                if(bound.prunable(it, current_sol_value, budget_left,
+                                  nb_taken(), best_sol_value)) {
+                    statistics.record_pruned_node();
+                    goto backtrack;
+                }
+                if constexpr(restore_states)
+                    _saved_states.emplace_back(current_sol_value, budget_left);
+                bound.take(it, nb_taken());
+                current_sol_value += it->first;
+                budget_left -= it->second;
+                current_sol.push_back(static_cast<item_index>(it - begin));
+                statistics.record_node(nb_taken());
+            }
+            if(current_sol_value <= best_sol_value) continue;
+            best_sol_value = current_sol_value;
+            if(nb_synced == 0)
+                best_sol.assign(prefix_sol.begin(), prefix_sol.end());
+            else
+                best_sol.resize(prefix_sol.size() + nb_synced);
+            best_sol.insert(best_sol.end(),
+                            current_sol.cbegin() +
+                                static_cast<std::ptrdiff_t>(nb_synced),
+                            current_sol.cend());
+            nb_synced = current_sol.size();
+            statistics.record_incumbent();
+        }
+        return current_sol.empty();
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_BNB_SEARCH_HPP
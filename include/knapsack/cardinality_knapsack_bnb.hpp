@@ -0,0 +1,265 @@
+#ifndef FHAMONIC_KNAPSACK_CARDINALITY_BRANCH_AND_BOUND_HPP
+#define FHAMONIC_KNAPSACK_CARDINALITY_BRANCH_AND_BOUND_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <range/v3/algorithm/sort.hpp>
+#include <range/v3/view/zip.hpp>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/fractional_knapsack.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack with at most max_nb_items taken items. The cardinality
+// constraint is relaxed with a Lagrangian multiplier 'lambda' chosen at
+// construction, the bound of a node taking 'count' items is then
+//
+//     value + lambda * (max_nb_items - count) + LP(values - lambda)
+//
+// where LP is the Dantzig bound of the remaining items whose value exceeds
+// lambda. The items are sorted by decreasing ratio of their value minus
+// lambda by their cost, so that the bound of a node is computed from its
+// depth and the depth first search of knapsack_bnb is reused with this bound.
+template <typename C, typename RI, typename VM, typename CM>
+class cardinality_knapsack_bnb {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    using dfs = sorted_items_dfs<V, C, W>;
+    using value_cost_iterator = typename dfs::value_cost_iterator;
+    using item_index = typename dfs::item_index;
+
+    C _budget;
+    std::size_t _max_nb_items;
+    V _lambda;
+    std::pmr::vector<I> _permuted_items;
+    std::pmr::vector<std::pair<V, C>> _value_cost_pairs;
+    std::pmr::vector<item_index> _best_sol;
+    dfs _dfs;
+    W _bound_rounding_error;
+    bnb_statistics_recorder _statistics;
+
+private:
+    // Items whose value exceeds lambda come first, by decreasing ratio of
+    // their value minus lambda by their cost, then the others by decreasing
+    // value by cost ratio.
+    static bool lagrangian_order(const V lambda, const std::pair<V, C> & p1,
+                                 const std::pair<V, C> & p2) noexcept {
+        const bool reduced1 = p1.first > lambda;
+        const bool reduced2 = p2.first > lambda;
+        if(reduced1 != reduced2) return reduced1;
+        const V shift = reduced1 ? lambda : V{0};
+        return static_cast<double>(p1.first - shift) *
+                   static_cast<double>(p2.second) >
+               static_cast<double>(p2.first - shift) *
+                   static_cast<double>(p1.second);
+    }
+
+    // Lagrangian dual value for 'lambda' of the whole instance, used to
+    // choose lambda, and the number of items taken by its LP solution
+    std::pair<double, double> lagrangian_dual(
+        const V lambda,
+        std::vector<std::pair<V, C>> & items) const noexcept {
+        const auto reduced_end = std::partition(
+            items.begin(), items.end(),
+            [lambda](const auto & p) { return p.first > lambda; });
+        const auto [break_item, budget_left] = fractional_partition(
+            items.begin(), reduced_end, _budget,
+            [lambda](const auto & p) { return p.first - lambda; },
+            &std::pair<V, C>::second);
+        double bound = static_cast<double>(lambda) *
+                       static_cast<double>(_max_nb_items);
+        double nb_taken = static_cast<double>(break_item - items.begin());
+        for(auto it = items.begin(); it != break_item; ++it)
+            bound += static_cast<double>(it->first - lambda);
+        if(break_item != reduced_end) {
+            const double fraction = static_cast<double>(budget_left) /
+                                    static_cast<double>(break_item->second);
+            bound += fraction * static_cast<double>(break_item->first - lambda);
+            nb_taken += fraction;
+        }
+        return {bound, nb_taken};
+    }
+
+    // The dual is convex in lambda and its slope is max_nb_items minus the
+    // number of items taken by the LP, that decreases with lambda. Lambda is
+    // searched by bisection for the point where the slope changes sign.
+    void choose_lambda() noexcept {
+        _lambda = V{0};
+        std::vector<std::pair<V, C>> items(_value_cost_pairs.begin(),
+                                           _value_cost_pairs.end());
+        if(lagrangian_dual(V{0}, items).second <=
+           static_cast<double>(_max_nb_items))
+            return;
+        V low = V{0};
+        V high = std::ranges::max(items, {}, &std::pair<V, C>::first).first;
+        for(int iteration = 0; iteration < 64; ++iteration) {
+            const V middle = low + (high - low) / 2;
+            if(middle == low || middle == high) break;
+            if(lagrangian_dual(middle, items).second >
+               static_cast<double>(_max_nb_items))
+                low = middle;
+            else
+                high = middle;
+        }
+        _lambda = (lagrangian_dual(low, items).first <
+                   lagrangian_dual(high, items).first)
+                      ? low
+                      : high;
+    }
+
+    W compute_upper_bound(auto it, const auto end, const W value,
+                          C budget_left,
+                          const std::size_t count) const noexcept {
+        if(count == _max_nb_items) return value;
+        W bound = value + static_cast<W>(_lambda) *
+                              static_cast<W>(_max_nb_items - count);
+        for(; it < end && it->first > _lambda; ++it) {
+            if(budget_left < it->second)
+                return bound +
+                       static_cast<W>(static_cast<double>(budget_left) *
+                                      static_cast<double>(it->first - _lambda) /
+                                      static_cast<double>(it->second));
+            budget_left -= it->second;
+            bound += it->first - _lambda;
+        }
+        return bound;
+    }
+
+    bool prunable(W bound, const W best_sol_value) const noexcept {
+        if constexpr(std::floating_point<W>)
+            bound += std::abs(bound) * _bound_rounding_error;
+        return bound <= best_sol_value;
+    }
+
+    // Lagrangian bound of the items sorted by lagrangian_order
+    struct lagrangian_bound {
+        const cardinality_knapsack_bnb & solver;
+
+        bool can_take(const std::size_t nb_taken) const noexcept {
+            return nb_taken < solver._max_nb_items;
+        }
+        constexpr value_cost_iterator next(const value_cost_iterator it,
+                                           const std::size_t) const noexcept {
+            return it;
+        }
+        constexpr void take(const value_cost_iterator,
+                            const std::size_t) const noexcept {}
+        bool prunable(const value_cost_iterator it, const W value,
+                      const C budget_left, const std::size_t nb_taken,
+                      const W best_sol_value) const noexcept {
+            return solver.prunable(
+                solver.compute_upper_bound(it, solver._value_cost_pairs.cend(),
+                                           value, budget_left, nb_taken),
+                best_sol_value);
+        }
+    };
+
+    template <typename ST>
+    bool iterative_bnb(const ST & stoken) noexcept {
+        _statistics.start_solve();
+        _best_sol.resize(0);
+        W best_sol_value = 0;
+        const bool completed = _dfs.search(
+            lagrangian_bound{*this}, stoken, _value_cost_pairs.cbegin(),
+            _value_cost_pairs.cbegin(), _value_cost_pairs.cend(), W{0},
+            _budget, best_sol_value, {}, _best_sol, _statistics);
+        _statistics.stop_solve();
+        return completed;
+    }
+
+public:
+    cardinality_knapsack_bnb(const C budget, const RI & items,
+                             const VM & value_map, const CM & cost_map,
+                             const std::size_t max_nb_items,
+                             std::pmr::memory_resource * resource =
+                                 std::pmr::get_default_resource()) noexcept
+        : _budget(budget)
+        , _max_nb_items(max_nb_items)
+        , _lambda(0)
+        , _permuted_items(resource)
+        , _value_cost_pairs(resource)
+        , _best_sol(resource)
+        , _dfs(resource)
+        , _bound_rounding_error(0) {
+        _statistics.start_preprocessing();
+        if constexpr(std::ranges::sized_range<RI>) {
+            _permuted_items.reserve(std::ranges::size(items));
+            _value_cost_pairs.reserve(std::ranges::size(items));
+        }
+
+        for_each_profitable_item(
+            _budget, items, value_map, cost_map,
+            [this](std::size_t, auto && i, const V value, const C cost) {
+                _permuted_items.emplace_back(i);
+                _value_cost_pairs.emplace_back(value, cost);
+            });
+        _max_nb_items = std::min(_max_nb_items, _value_cost_pairs.size());
+
+        if(!_value_cost_pairs.empty()) choose_lambda();
+        auto zip_view = ranges::view::zip(_value_cost_pairs, _permuted_items);
+        ranges::sort(zip_view, [this](auto p1, auto p2) {
+            return lagrangian_order(_lambda, p1.first, p2.first);
+        });
+        _best_sol.reserve(_max_nb_items);
+        _dfs.reserve(_max_nb_items);
+        // a bound sums at most n + 2 terms, lambda terms included
+        if constexpr(std::floating_point<W>)
+            _bound_rounding_error =
+                static_cast<W>(_value_cost_pairs.size() + 4) *
+                std::numeric_limits<W>::epsilon();
+        _statistics.stop_preprocessing();
+    }
+
+    void solve() noexcept { iterative_bnb(never_stop_token{}); }
+
+    // Returns false if the search was stopped by 'stoken' before completion
+    template <search_stop_token ST>
+    bool solve(const ST & stoken) noexcept {
+        return iterative_bnb(stoken);
+    }
+
+    // A timeout of zero waits for the search to complete
+    template <typename _Rep, typename _Period>
+    bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
+        if(timeout == timeout.zero()) return iterative_bnb(never_stop_token{});
+        return iterative_bnb(deadline_stop_token(timeout));
+    }
+
+    auto solution() const noexcept {
+        return std::ranges::views::transform(
+            _best_sol, [this](const item_index i) -> const I & {
+                return _permuted_items[i];
+            });
+    }
+
+    // Multiplier of the cardinality constraint in the bounds
+    V lagrangian_multiplier() const noexcept { return _lambda; }
+
+    const bnb_statistics & statistics() const noexcept {
+        return _statistics.statistics();
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_CARDINALITY_BRANCH_AND_BOUND_HPP
@@ -0,0 +1,151 @@
+#ifndef FHAMONIC_KNAPSACK_CARDINALITY_DYNAMIC_PROGRAMMING_HPP
+#define FHAMONIC_KNAPSACK_CARDINALITY_DYNAMIC_PROGRAMMING_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/cost_reduction.hpp"
+#include "knapsack/statistics.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack with at most max_nb_items taken items for integral costs. The
+// table holds, for every number of items j and capacity w, the best value of
+// at most j items of cost at most w, and is updated in place for each item.
+// Whether each item improved each cell is recorded in a bitset of
+// nb_items * (max_nb_items + 1) * (budget + 1) bits, from which the solution
+// is collected backward.
+template <typename C, typename RI, typename VM, typename CM>
+    requires std::integral<C>
+class cardinality_knapsack_dp {
+public:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+private:
+    C _budget;
+    std::size_t _max_nb_items;
+    std::vector<I> _items;
+    std::vector<std::pair<V, C>> _value_cost_pairs;
+    std::vector<W> _tab;
+    std::vector<std::uint64_t> _taken;
+    dp_statistics _statistics;
+
+private:
+    std::size_t row_size() const noexcept {
+        return static_cast<std::size_t>(_budget) + 1;
+    }
+
+    std::size_t layer_size() const noexcept {
+        return (_max_nb_items + 1) * row_size();
+    }
+
+    void set_taken(const std::size_t bit) noexcept {
+        _taken[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+
+    bool is_taken(const std::size_t bit) const noexcept {
+        return (_taken[bit / 64] >> (bit % 64)) & 1;
+    }
+
+public:
+    cardinality_knapsack_dp(const C budget, const RI & items,
+                            const VM & value_map, const CM & cost_map,
+                            const std::size_t max_nb_items) noexcept
+        : _budget(std::max(budget, C{0})), _max_nb_items(max_nb_items) {
+        std::chrono::steady_clock::time_point start_time;
+        if constexpr(enable_statistics)
+            start_time = std::chrono::steady_clock::now();
+        if constexpr(std::ranges::sized_range<RI>) {
+            const std::size_t nb_items = std::ranges::size(items);
+            _items.reserve(nb_items);
+            _value_cost_pairs.reserve(nb_items);
+        }
+
+        // taking an item of non positive value never improves a solution
+        for(auto && i : items) {
+            const V value = value_map(i);
+            if(value <= static_cast<V>(0)) continue;
+            const C cost = cost_map(i);
+            if(cost > budget) continue;
+            _items.emplace_back(i);
+            _value_cost_pairs.emplace_back(value, cost);
+        }
+        _max_nb_items = std::min(_max_nb_items, _items.size());
+        // the costs are divided in place, solutions only depend on the items
+        _budget = reduce_budget(_budget, _value_cost_pairs,
+                                &std::pair<V, C>::second)
+                      .budget;
+        if constexpr(enable_statistics)
+            _statistics.preprocessing_time =
+                std::chrono::steady_clock::now() - start_time;
+    }
+
+    // The rows of at most j items are updated by decreasing j, so that each
+    // reads the row of j - 1 items before the current item is added to it.
+    void solve() {
+        std::chrono::steady_clock::time_point start_time;
+        if constexpr(enable_statistics) {
+            _statistics = dp_statistics{
+                .preprocessing_time = _statistics.preprocessing_time};
+            start_time = std::chrono::steady_clock::now();
+        }
+        const std::size_t nb_columns = row_size();
+        _tab.assign(layer_size(), W{0});
+        _taken.assign((_items.size() * layer_size() + 63) / 64, 0);
+        for(std::size_t i = 0; i < _items.size(); ++i) {
+            const auto [value, cost] = _value_cost_pairs[i];
+            const std::size_t c = static_cast<std::size_t>(cost);
+            for(std::size_t j = _max_nb_items; j > 0; --j) {
+                W * const row = _tab.data() + j * nb_columns;
+                const W * const previous_row = row - nb_columns;
+                const std::size_t bits = i * layer_size() + j * nb_columns;
+                for(std::size_t w = c; w < nb_columns; ++w) {
+                    const W with = previous_row[w - c] + value;
+                    if(with <= row[w]) continue;
+                    row[w] = with;
+                    set_taken(bits + w);
+                }
+            }
+        }
+        if constexpr(enable_statistics) {
+            _statistics.nb_cells = _items.size() * layer_size();
+            _statistics.solve_time =
+                std::chrono::steady_clock::now() - start_time;
+        }
+    }
+
+    std::vector<I> solution() const {
+        std::vector<I> solution;
+        std::size_t j = _max_nb_items;
+        std::size_t w = static_cast<std::size_t>(_budget);
+        for(std::size_t i = _items.size(); i-- > 0 && j > 0;) {
+            if(!is_taken(i * layer_size() + j * row_size() + w)) continue;
+            solution.push_back(_items[i]);
+            --j;
+            w -= static_cast<std::size_t>(_value_cost_pairs[i].second);
+        }
+        return solution;
+    }
+
+    W solution_value() const noexcept {
+        return _tab.empty() ? W{0} : _tab.back();
+    }
+
+    const dp_statistics & statistics() const noexcept { return _statistics; }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_CARDINALITY_DYNAMIC_PROGRAMMING_HPP
@@ -0,0 +1,350 @@
+#ifndef FHAMONIC_KNAPSACK_CONFLICT_BRANCH_AND_BOUND_HPP
+#define FHAMONIC_KNAPSACK_CONFLICT_BRANCH_AND_BOUND_HPP
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <range/v3/algorithm/sort.hpp>
+#include <range/v3/view/zip.hpp>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack where some pairs of items cannot be taken together. The
+// conflicts are given as pairs of positions in 'items' and stored as bitset
+// rows over the items sorted by value/cost ratio. The depth first search
+// keeps, for each taken item, the bitset of the items still compatible with
+// the taken ones, obtained with one word-parallel 'and not' per word.
+//
+// The items are partitioned into cliques of the conflict graph at
+// construction. For any ratio mu, the value of the items compatible with a
+// node and of cost at most budget_left is at most
+//
+//     mu * budget_left + sum over the cliques of max(value - mu * cost, 0)
+//
+// since at most one item of a clique is taken. With mu the ratio of the
+// critical item of the Dantzig bound, this bound is never larger than the
+// Dantzig one, and the smaller of the two is used.
+template <typename C, typename RI, typename VM, typename CM>
+class conflict_knapsack_bnb {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    using dfs = sorted_items_dfs<V, C, W>;
+    using value_cost_iterator = typename dfs::value_cost_iterator;
+    using item_index = typename dfs::item_index;
+    using word = std::uint64_t;
+    static constexpr std::size_t word_size = 64;
+
+    C _budget;
+    std::pmr::vector<I> _permuted_items;
+    std::pmr::vector<std::pair<V, C>> _value_cost_pairs;
+    std::size_t _nb_words;
+    std::pmr::vector<word> _conflicts;
+    std::pmr::vector<std::uint32_t> _clique_of;
+    std::pmr::vector<double> _clique_excess;
+    std::pmr::vector<std::uint32_t> _touched_cliques;
+    // Bitsets of the compatible items after each taken item
+    std::pmr::vector<word> _compatible;
+    std::pmr::vector<item_index> _best_sol;
+    dfs _dfs;
+    double _bound_rounding_error;
+    bnb_statistics_recorder _statistics;
+
+private:
+    double value_cost_ratio(const std::pair<V, C> & p) const noexcept {
+        if constexpr(std::numeric_limits<float>::is_iec559) {
+            return static_cast<double>(p.first) / static_cast<double>(p.second);
+        } else {
+            return (p.second == 0) ? std::numeric_limits<double>::max()
+                                   : (static_cast<double>(p.first) /
+                                      static_cast<double>(p.second));
+        }
+    }
+
+    std::size_t nb_items() const noexcept { return _value_cost_pairs.size(); }
+
+    word * conflicts_row(const std::size_t i) noexcept {
+        return _conflicts.data() + i * _nb_words;
+    }
+    const word * conflicts_row(const std::size_t i) const noexcept {
+        return _conflicts.data() + i * _nb_words;
+    }
+    // Items compatible with the taken ones at a node of nb_taken items
+    word * compatible(const std::size_t nb_taken) noexcept {
+        return _compatible.data() + nb_taken * _nb_words;
+    }
+
+    // First item of 'bits' at position 'i' or after, nb_items() if none
+    std::size_t next_item(const word * bits, std::size_t i) const noexcept {
+        std::size_t w = i / word_size;
+        if(w >= _nb_words) return nb_items();
+        word remaining = bits[w] & (~word{0} << (i % word_size));
+        while(remaining == 0) {
+            if(++w == _nb_words) return nb_items();
+            remaining = bits[w];
+        }
+        return w * word_size +
+               static_cast<std::size_t>(std::countr_zero(remaining));
+    }
+
+    // Greedy partition of the items in cliques, each item joins the first
+    // clique of its previous neighbors that it is adjacent to entirely.
+    void compute_cliques() {
+        std::vector<word> members;
+        std::vector<std::size_t> last_tried;
+        _clique_of.resize(nb_items());
+        for(std::size_t i = 0; i < nb_items(); ++i) {
+            const word * row = conflicts_row(i);
+            std::uint32_t clique =
+                static_cast<std::uint32_t>(last_tried.size());
+            for(std::size_t j = next_item(row, 0); j < i;
+                j = next_item(row, j + 1)) {
+                const std::uint32_t k = _clique_of[j];
+                if(last_tried[k] == i) continue;
+                last_tried[k] = i;
+                const word * clique_members = members.data() + k * _nb_words;
+                bool adjacent = true;
+                for(std::size_t w = 0; adjacent && w < _nb_words; ++w)
+                    adjacent = (clique_members[w] & ~row[w]) == 0;
+                if(!adjacent) continue;
+                clique = k;
+                break;
+            }
+            if(clique == last_tried.size()) {
+                last_tried.push_back(i);
+                members.resize(members.size() + _nb_words, 0);
+            }
+            _clique_of[i] = clique;
+            members[clique * _nb_words + i / word_size] |=
+                word{1} << (i % word_size);
+        }
+        _clique_excess.assign(last_tried.size(), 0.0);
+        _touched_cliques.reserve(last_tried.size());
+    }
+
+    // Upper bound of the solutions extending a node whose compatible items
+    // are 'compatible', from position 'i' on
+    W compute_upper_bound(const word * compatible, const std::size_t i,
+                          const W value, const C budget_left) noexcept {
+        W dantzig_bound = value;
+        C dantzig_budget_left = budget_left;
+        std::size_t critical = next_item(compatible, i);
+        for(; critical < nb_items();
+            critical = next_item(compatible, critical + 1)) {
+            const auto & [item_value, item_cost] =
+                _value_cost_pairs[critical];
+            if(dantzig_budget_left < item_cost) break;
+            dantzig_budget_left -= item_cost;
+            dantzig_bound += item_value;
+        }
+        double mu = 0.0;
+        if(critical < nb_items()) {
+            mu = value_cost_ratio(_value_cost_pairs[critical]);
+            dantzig_bound += static_cast<W>(
+                static_cast<double>(dantzig_budget_left) * mu);
+        }
+
+        // the items after the critical one have no positive excess for mu,
+        // unless there is no critical item and mu is 0
+        double clique_bound = static_cast<double>(value) +
+                              mu * static_cast<double>(budget_left);
+        for(std::size_t j = next_item(compatible, i); j < critical;
+            j = next_item(compatible, j + 1)) {
+            const auto & [item_value, item_cost] = _value_cost_pairs[j];
+            const double excess = static_cast<double>(item_value) -
+                                  mu * static_cast<double>(item_cost);
+            double & clique_excess = _clique_excess[_clique_of[j]];
+            if(clique_excess == 0.0) _touched_cliques.push_back(_clique_of[j]);
+            clique_excess = std::max(clique_excess, excess);
+        }
+        for(const std::uint32_t k : _touched_cliques) {
+            clique_bound += _clique_excess[k];
+            _clique_excess[k] = 0.0;
+        }
+        _touched_cliques.resize(0);
+        clique_bound += std::abs(clique_bound) * _bound_rounding_error;
+        if(clique_bound >= static_cast<double>(dantzig_bound))
+            return dantzig_bound;
+        return static_cast<W>(clique_bound);
+    }
+
+    bool prunable(W bound, const W best_sol_value) const noexcept {
+        if constexpr(std::floating_point<W>)
+            bound += std::abs(bound) * static_cast<W>(_bound_rounding_error);
+        return bound <= best_sol_value;
+    }
+
+    // Bound of the items sorted by value/cost ratio that are compatible with
+    // the taken ones, whose bitsets are computed as items are taken
+    struct conflict_bound {
+        conflict_knapsack_bnb & solver;
+
+        std::size_t position(const value_cost_iterator it) const noexcept {
+            return static_cast<std::size_t>(
+                it - solver._value_cost_pairs.cbegin());
+        }
+
+        constexpr bool can_take(const std::size_t) const noexcept {
+            return true;
+        }
+        value_cost_iterator next(const value_cost_iterator it,
+                                 const std::size_t nb_taken) const noexcept {
+            return solver._value_cost_pairs.cbegin() +
+                   static_cast<std::ptrdiff_t>(solver.next_item(
+                       solver.compatible(nb_taken), position(it)));
+        }
+        void take(const value_cost_iterator it,
+                  const std::size_t nb_taken) const noexcept {
+            const std::size_t i = position(it);
+            const word * compatible = solver.compatible(nb_taken);
+            word * next_compatible = solver.compatible(nb_taken + 1);
+            const word * row = solver.conflicts_row(i);
+            // the words before i are never read again from the next level
+            for(std::size_t w = i / word_size; w < solver._nb_words; ++w)
+                next_compatible[w] = compatible[w] & ~row[w];
+        }
+        bool prunable(const value_cost_iterator it, const W value,
+                      const C budget_left, const std::size_t nb_taken,
+                      const W best_sol_value) const noexcept {
+            return solver.prunable(
+                solver.compute_upper_bound(solver.compatible(nb_taken),
+                                           position(it), value, budget_left),
+                best_sol_value);
+        }
+    };
+
+    template <typename ST>
+    bool iterative_bnb(const ST & stoken) noexcept {
+        _statistics.start_solve();
+        _best_sol.resize(0);
+        W best_sol_value = 0;
+        const bool completed = _dfs.search(
+            conflict_bound{*this}, stoken, _value_cost_pairs.cbegin(),
+            _value_cost_pairs.cbegin(), _value_cost_pairs.cend(), W{0},
+            _budget, best_sol_value, {}, _best_sol, _statistics);
+        _statistics.stop_solve();
+        return completed;
+    }
+
+public:
+    // 'conflicts' is a range of pairs of positions of the items that cannot
+    // be taken together, a position being the index of an item in 'items'.
+    // Throws std::invalid_argument if a position is not lower than the
+    // number of items. The bitset rows take nb_items^2 / 8 bytes.
+    template <typename RC>
+    conflict_knapsack_bnb(const C budget, const RI & items,
+                          const VM & value_map, const CM & cost_map,
+                          const RC & conflicts,
+                          std::pmr::memory_resource * resource =
+                              std::pmr::get_default_resource())
+        : _budget(budget)
+        , _permuted_items(resource)
+        , _value_cost_pairs(resource)
+        , _nb_words(0)
+        , _conflicts(resource)
+        , _clique_of(resource)
+        , _clique_excess(resource)
+        , _touched_cliques(resource)
+        , _compatible(resource)
+        , _best_sol(resource)
+        , _dfs(resource)
+        , _bound_rounding_error(0.0) {
+        _statistics.start_preprocessing();
+        std::vector<std::size_t> positions;
+        const std::size_t nb_positions = for_each_profitable_item(
+            _budget, items, value_map, cost_map,
+            [&](const std::size_t position, auto && i, const V value,
+                const C cost) {
+                _permuted_items.emplace_back(i);
+                _value_cost_pairs.emplace_back(value, cost);
+                positions.push_back(position);
+            });
+
+        auto zip_view = ranges::view::zip(_value_cost_pairs, _permuted_items,
+                                          positions);
+        ranges::sort(zip_view, [this](auto p1, auto p2) {
+            return value_cost_ratio(std::get<0>(p1)) >
+                   value_cost_ratio(std::get<0>(p2));
+        });
+        constexpr std::size_t no_item = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> item_of_position(nb_positions, no_item);
+        for(std::size_t i = 0; i < positions.size(); ++i)
+            item_of_position[positions[i]] = i;
+
+        const std::size_t n = nb_items();
+        _nb_words = (n + word_size - 1) / word_size;
+        _conflicts.assign(n * _nb_words, 0);
+        for(auto && [position1, position2] : conflicts) {
+            const std::size_t i =
+                item_of_position[checked_position(position1, nb_positions)];
+            const std::size_t j =
+                item_of_position[checked_position(position2, nb_positions)];
+            if(i == no_item || j == no_item || i == j) continue;
+            conflicts_row(i)[j / word_size] |= word{1} << (j % word_size);
+            conflicts_row(j)[i / word_size] |= word{1} << (i % word_size);
+        }
+        compute_cliques();
+
+        _compatible.assign((n + 1) * _nb_words, 0);
+        for(std::size_t i = 0; i < n; ++i)
+            _compatible[i / word_size] |= word{1} << (i % word_size);
+        _best_sol.reserve(n);
+        _dfs.reserve(n);
+        // the clique bound sums at most n + 2 terms in double
+        _bound_rounding_error =
+            static_cast<double>(n + 4) * std::numeric_limits<double>::epsilon();
+        _statistics.stop_preprocessing();
+    }
+
+    void solve() noexcept { iterative_bnb(never_stop_token{}); }
+
+    // Returns false if the search was stopped by 'stoken' before completion
+    template <search_stop_token ST>
+    bool solve(const ST & stoken) noexcept {
+        return iterative_bnb(stoken);
+    }
+
+    // A timeout of zero waits for the search to complete
+    template <typename _Rep, typename _Period>
+    bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
+        if(timeout == timeout.zero()) return iterative_bnb(never_stop_token{});
+        return iterative_bnb(deadline_stop_token(timeout));
+    }
+
+    auto solution() const noexcept {
+        return std::ranges::views::transform(
+            _best_sol, [this](const item_index i) -> const I & {
+                return _permuted_items[i];
+            });
+    }
+
+    const bnb_statistics & statistics() const noexcept {
+        return _statistics.statistics();
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_CONFLICT_BRANCH_AND_BOUND_HPP
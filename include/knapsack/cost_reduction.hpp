@@ -0,0 +1,43 @@
+#ifndef FHAMONIC_KNAPSACK_COST_REDUCTION_HPP
+#define FHAMONIC_KNAPSACK_COST_REDUCTION_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <numeric>
+#include <ranges>
+
+namespace fhamonic {
+namespace knapsack {
+
+template <std::integral C>
+struct reduced_budget {
+    C budget;
+    C cost_divisor;
+};
+
+// Shrinks an integral budget without changing the set of feasible solutions.
+// The budget is clamped to the total cost of the items, then the costs and
+// the budget are divided by the gcd of the costs. Expects the items costing
+// more than the budget to have been removed. 'projection' maps an element of
+// 'items' to a reference to its cost.
+template <std::integral C, std::ranges::forward_range R,
+          typename P = std::identity>
+reduced_budget<C> reduce_budget(const C budget, R && items,
+                                P projection = {}) noexcept {
+    C total_cost = 0;
+    C divisor = 0;
+    for(auto && i : items) {
+        const C cost = std::invoke(projection, i);
+        total_cost += std::min(cost, static_cast<C>(budget - total_cost));
+        divisor = std::gcd(divisor, cost);
+    }
+    if(divisor <= 1) return {total_cost, C{1}};
+    for(auto && i : items) std::invoke(projection, i) /= divisor;
+    return {static_cast<C>(total_cost / divisor), divisor};
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_COST_REDUCTION_HPP
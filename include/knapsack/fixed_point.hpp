@@ -0,0 +1,82 @@
+#ifndef FHAMONIC_KNAPSACK_FIXED_POINT_HPP
+#define FHAMONIC_KNAPSACK_FIXED_POINT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ranges>
+
+namespace fhamonic {
+namespace knapsack {
+
+// Whether x is within the rounding error of the integer r
+template <std::floating_point T>
+bool is_rounded_integer(const T x, const T r) noexcept {
+    return std::abs(x - r) <= 4 * std::numeric_limits<T>::epsilon() *
+                                  std::max(T{1}, std::abs(x));
+}
+
+// Smallest power of ten 10^d with d <= max_nb_decimals that turns every
+// projected element of 'r' into an integer of at most 53 bits, or 0 if there
+// is none. Numbers like 0.1 are not exactly representable, they are accepted
+// when the scaled number is within a few ulps of an integer.
+template <std::ranges::forward_range R, typename P = std::identity>
+std::int64_t decimal_scale(R && r, P projection = {},
+                           const int max_nb_decimals = 6) noexcept {
+    constexpr double max_integer = 9007199254740992.0;  // 2^53
+    std::int64_t scale = 1;
+    for(int d = 0; d <= max_nb_decimals; ++d, scale *= 10) {
+        bool integral = true;
+        for(auto && e : r) {
+            const double x =
+                static_cast<double>(std::invoke(projection, e)) *
+                static_cast<double>(scale);
+            if(std::abs(x) > max_integer) return 0;
+            if(!is_rounded_integer(x, std::round(x))) {
+                integral = false;
+                break;
+            }
+        }
+        if(integral) return scale;
+    }
+    return 0;
+}
+
+// Nearest integer to x * scale
+template <typename T>
+std::int64_t to_fixed_point(const T x, const std::int64_t scale) noexcept {
+    if constexpr(std::floating_point<T>)
+        return std::llround(static_cast<double>(x) *
+                            static_cast<double>(scale));
+    else
+        return static_cast<std::int64_t>(x) * scale;
+}
+
+// Largest integer not greater than x * scale, up to rounding errors,
+// saturated to the range of std::int64_t
+template <typename T>
+std::int64_t to_fixed_point_floor(const T x,
+                                  const std::int64_t scale) noexcept {
+    if constexpr(std::floating_point<T>) {
+        constexpr double int64_bound = 9223372036854775808.0;  // 2^63
+        const double scaled =
+            static_cast<double>(x) * static_cast<double>(scale);
+        if(scaled >= int64_bound)
+            return std::numeric_limits<std::int64_t>::max();
+        if(scaled <= -int64_bound)
+            return std::numeric_limits<std::int64_t>::min();
+        const double rounded = std::round(scaled);
+        return static_cast<std::int64_t>(
+            is_rounded_integer(scaled, rounded) ? rounded : std::floor(scaled));
+    } else {
+        return static_cast<std::int64_t>(x) * scale;
+    }
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_FIXED_POINT_HPP
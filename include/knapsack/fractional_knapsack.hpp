@@ -0,0 +1,130 @@
+#ifndef FHAMONIC_KNAPSACK_FRACTIONAL_KNAPSACK_HPP
+#define FHAMONIC_KNAPSACK_FRACTIONAL_KNAPSACK_HPP
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+template <typename It, typename C>
+struct fractional_partition_result {
+    It break_item;
+    C budget_left;
+};
+
+// Partitions the items of [first, last), of positive values, in expected
+// linear time so that those before the returned break item are the ones
+// fully taken by the Dantzig LP solution for 'budget', i.e. the items of
+// largest value by cost ratios whose costs sum at most 'budget'. The break
+// item is 'last' if every item fits, otherwise the budget left is smaller
+// than its cost. Instead of sorting, the remaining items are split at the
+// median ratio by std::nth_element and the half of larger ratios is taken
+// if it fits, the other half is discarded otherwise.
+template <std::random_access_iterator It, typename C, typename VP,
+          typename CP>
+fractional_partition_result<It, C> fractional_partition(
+    It first, It last, C budget, VP value_projection,
+    CP cost_projection) noexcept {
+    const auto ratio = [&](auto && i) {
+        const double cost =
+            static_cast<double>(std::invoke(cost_projection, i));
+        const double value =
+            static_cast<double>(std::invoke(value_projection, i));
+        return (cost == 0) ? std::numeric_limits<double>::infinity()
+                           : value / cost;
+    };
+    const auto by_ratio = [&](auto && i, auto && j) {
+        return ratio(i) > ratio(j);
+    };
+    const It end = last;
+    // the items of [first, last) cost more than the budget when last != end
+    while(last - first > 1) {
+        const It middle = first + (last - first) / 2;
+        std::nth_element(first, middle, last, by_ratio);
+        // the costs are subtracted from the budget rather than summed, and
+        // the half is discarded as soon as one does not fit, so that the sum
+        // of the costs of a half, that may exceed C, is never computed
+        C budget_left = budget;
+        It it = first;
+        for(; it != middle; ++it) {
+            const C cost = std::invoke(cost_projection, *it);
+            if(cost > budget_left) break;
+            budget_left -= cost;
+        }
+        if(it == middle) {
+            budget = budget_left;
+            first = middle;
+        } else {
+            last = middle;
+        }
+    }
+    if(first == last) return {first, budget};
+    if(last == end && std::invoke(cost_projection, *first) <= budget)
+        return {last, static_cast<C>(budget -
+                                     std::invoke(cost_projection, *first))};
+    return {first, budget};
+}
+
+template <typename I, typename W>
+struct fractional_knapsack_solution {
+    double value;
+    W taken_value;
+    std::optional<I> break_item;
+    double break_fraction;
+};
+
+// LP relaxation of the 0-1 knapsack in expected O(n), without sorting the
+// items. 'value' is the LP optimum, the sum of 'taken_value', the value of
+// the items fully taken, and of the 'break_fraction' of the value of the
+// break item, if any.
+template <typename C, typename RI, typename VM, typename CM>
+auto fractional_knapsack(const C budget, const RI & items,
+                         const VM & value_map, const CM & cost_map) {
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    struct entry {
+        V value;
+        C cost;
+        I item;
+    };
+    fractional_knapsack_solution<I, W> solution{0.0, W{0}, std::nullopt, 0.0};
+    if(budget < 0) return solution;
+    std::vector<entry> entries;
+    if constexpr(std::ranges::sized_range<RI>)
+        entries.reserve(std::ranges::size(items));
+    for(auto && i : items) {
+        const V value = value_map(i);
+        if(value <= static_cast<V>(0)) continue;
+        entries.push_back({value, cost_map(i), i});
+    }
+    const auto [break_item, budget_left] =
+        fractional_partition(entries.begin(), entries.end(), budget,
+                             &entry::value, &entry::cost);
+    for(auto it = entries.begin(); it != break_item; ++it)
+        solution.taken_value += it->value;
+    solution.value = static_cast<double>(solution.taken_value);
+    if(break_item == entries.end()) return solution;
+    solution.break_item = break_item->item;
+    solution.break_fraction = static_cast<double>(budget_left) /
+                              static_cast<double>(break_item->cost);
+    solution.value +=
+        solution.break_fraction * static_cast<double>(break_item->value);
+    return solution;
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_FRACTIONAL_KNAPSACK_HPP
@@ -1,12 +1,16 @@
 #ifndef FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 #define FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 
+#include <algorithm>
 #include <chrono>
-#include <future>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
 #include <ranges>
-#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -15,38 +19,90 @@
 #include <range/v3/view/transform.hpp>
 #include <range/v3/view/zip.hpp>
 
+#include "knapsack/accumulator.hpp"
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
 namespace fhamonic {
 namespace knapsack {
 
+enum class search_strategy { depth_first, best_first };
+
 template <typename C, typename RI, typename VM, typename CM>
 class knapsack_bnb {
 private:
     using I = std::ranges::range_value_t<RI>;
     using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    using dfs = sorted_items_dfs<V, C, W>;
+    using value_cost_iterator = typename dfs::value_cost_iterator;
+    using item_index = typename dfs::item_index;
+
+    // Best first search nodes. The open nodes are kept in a binary heap and the
+    // items taken along the paths are recorded as a tree of taken_item so that
+    // nodes share their common prefix. Both pools keep their capacity from one
+    // solve to the next.
+    struct open_node {
+        W bound;
+        W value;
+        C budget_left;
+        std::uint32_t depth;
+        std::uint32_t last_taken;
+    };
+    struct taken_item {
+        std::uint32_t previous;
+        std::uint32_t depth;
+    };
+    static constexpr std::uint32_t no_taken_item = UINT32_MAX;
 
+public:
+    static constexpr std::size_t default_max_nb_nodes = std::size_t{1} << 20;
+
+private:
     C _budget;
-    std::vector<I> _permuted_items;
-    std::vector<std::pair<V, C>> _value_cost_pairs;
-    std::vector<typename std::vector<std::pair<V, C>>::const_iterator>
-        _best_sol;
+    std::pmr::vector<I> _permuted_items;
+    std::pmr::vector<std::pair<V, C>> _value_cost_pairs;
+    std::pmr::vector<item_index> _best_sol;
+    bnb_statistics_recorder _statistics;
+
+    // Search stacks, reserved for the maximal depth at construction
+    dfs _dfs;
+    std::pmr::vector<item_index> _prefix_sol;
+
+    search_strategy _strategy;
+    std::size_t _max_nb_nodes;
+    W _tolerance;
+    double _relative_gap;
+    W _bound_rounding_error;
+    W _best_sol_value;
+    W _max_pruned_bound;
+    W _upper_bound;
+    std::pmr::vector<open_node> _open_nodes;
+    std::pmr::vector<taken_item> _taken_items;
 
 private:
     double value_cost_ratio(const std::pair<V, C> & p) const noexcept {
         if constexpr(std::numeric_limits<float>::is_iec559) {
-            return p.first / static_cast<double>(p.second);
+            return static_cast<double>(p.first) / static_cast<double>(p.second);
         } else {
             return (p.second == 0) ? std::numeric_limits<double>::max()
-                                   : (p.first / static_cast<double>(p.second));
+                                   : (static_cast<double>(p.first) /
+                                      static_cast<double>(p.second));
         }
     }
 
-    V computeUpperBound(auto it, const auto end, V bound_value,
+    // The fractional item is accounted in double so that the product of the
+    // budget left by its value cannot overflow
+    W computeUpperBound(auto it, const auto end, W bound_value,
                         C bound_budget_left) const noexcept {
         for(; it < end; ++it) {
             if(bound_budget_left < it->second)
-                return static_cast<V>(bound_value +
-                                      bound_budget_left * it->first /
-                                          static_cast<double>(it->second));
+                return bound_value +
+                       static_cast<W>(static_cast<double>(bound_budget_left) *
+                                      static_cast<double>(it->first) /
+                                      static_cast<double>(it->second));
             bound_budget_left -= it->second;
             bound_value += it->first;
         }
@@ -54,74 +110,191 @@ private:
         return bound_value;
     }
 
-    void iterative_bnb() noexcept {
-        _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
+    // Whether a node of upper bound 'bound' cannot improve best_sol_value by
+    // more than the tolerance or the relative gap. For floating point values,
+    // the bound is first rounded up by a bound on the relative rounding error
+    // of its sums. The largest pruned bound bounds the optimum value once the
+    // search is completed.
+    bool prunable(W bound, const W best_sol_value) noexcept {
+        if constexpr(std::floating_point<W>)
+            bound += std::abs(bound) * _bound_rounding_error;
+        if(bound > best_sol_value + _tolerance &&
+           (_relative_gap == 0.0 ||
+            static_cast<double>(bound - best_sol_value) >
+                _relative_gap * static_cast<double>(bound)))
+            return false;
+        _max_pruned_bound = std::max(_max_pruned_bound, bound);
+        return true;
+    }
+
+    // Dantzig bound of the items sorted by decreasing value/cost ratio
+    struct ratio_bound {
+        knapsack_bnb & solver;
+
+        constexpr bool can_take(const std::size_t) const noexcept {
+            return true;
+        }
+        constexpr value_cost_iterator next(const value_cost_iterator it,
+                                           const std::size_t) const noexcept {
+            return it;
+        }
+        constexpr void take(const value_cost_iterator,
+                            const std::size_t) const noexcept {}
+        bool prunable(const value_cost_iterator it, const W value,
+                      const C budget_left, const std::size_t,
+                      const W best_sol_value) const noexcept {
+            return solver.prunable(
+                solver.computeUpperBound(it, solver._value_cost_pairs.cend(),
+                                         value, budget_left),
+                best_sol_value);
+        }
+    };
+
+    // Explores depth first the solutions extending _prefix_sol with items
+    // from 'it', updates _best_sol when one is better than best_sol_value.
+    template <typename ST>
+    bool depth_first_search(const ST & stoken, const value_cost_iterator it,
+                            const W current_sol_value, const C budget_left,
+                            W & best_sol_value) noexcept {
+        return _dfs.search(ratio_bound{*this}, stoken,
+                           _value_cost_pairs.cbegin(), it,
+                           _value_cost_pairs.cend(), current_sol_value,
+                           budget_left, best_sol_value, _prefix_sol,
+                           _best_sol, _statistics);
+    }
+
+    void collect_taken_items(std::uint32_t last_taken,
+                             std::pmr::vector<item_index> & sol) {
+        sol.resize(0);
+        for(; last_taken != no_taken_item;
+            last_taken = _taken_items[last_taken].previous)
+            sol.push_back(_taken_items[last_taken].depth);
+        std::reverse(sol.begin(), sol.end());
+    }
+
+    // Pops the open node of highest bound and dives from it, taking the items
+    // that fit and pushing the nodes that skip them. When the node pool is
+    // full, the remaining open nodes are explored depth first by decreasing
+    // bound.
+    template <typename ST>
+    bool best_first_search(const ST & stoken) noexcept {
+        const auto begin = _value_cost_pairs.cbegin();
         const auto end = _value_cost_pairs.cend();
-        if(it == end) return;
-        std::vector<decltype(it)> current_sol;
-        V current_sol_value = 0;
-        V best_sol_value = 0;
-        C budget_left = _budget;
-        goto begin;
-    backtrack:
-        while(!current_sol.empty()) {
-            it = current_sol.back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            current_sol.pop_back();
-            for(++it; it < end; ++it) {
+        const std::size_t nb_items = _value_cost_pairs.size();
+        constexpr auto bound_less = [](const open_node & n1,
+                                       const open_node & n2) {
+            return n1.bound < n2.bound;
+        };
+        W & best_sol_value = _best_sol_value;
+        _open_nodes.resize(0);
+        _taken_items.resize(0);
+        _open_nodes.push_back({computeUpperBound(begin, end, 0, _budget), 0,
+                               _budget, 0, no_taken_item});
+        while(!_open_nodes.empty()) {
+            if(stoken.stop_requested()) return false;
+            std::pop_heap(_open_nodes.begin(), _open_nodes.end(), bound_less);
+            const open_node node = _open_nodes.back();
+            _open_nodes.pop_back();
+            if(prunable(node.bound, best_sol_value)) break;
+
+            if(_open_nodes.size() + nb_items > _max_nb_nodes ||
+               _taken_items.size() + nb_items > _max_nb_nodes) {
+                collect_taken_items(node.last_taken, _prefix_sol);
+                if(!depth_first_search(stoken, begin + node.depth, node.value,
+                                       node.budget_left, best_sol_value))
+                    return false;
+                continue;
+            }
+
+            W value = node.value;
+            C budget_left = node.budget_left;
+            std::uint32_t last_taken = node.last_taken;
+            for(std::size_t depth = node.depth; depth < nb_items; ++depth) {
+                const auto it = begin + static_cast<std::ptrdiff_t>(depth);
                 if(budget_left < it->second) continue;
-                if(computeUpperBound(it, end, current_sol_value, budget_left) <=
-                   best_sol_value)
-                    goto backtrack;
-            begin:
-                current_sol_value += it->first;
+                if(prunable(computeUpperBound(it, end, value, budget_left),
+                            best_sol_value)) {
+                    _statistics.record_pruned_node();
+                    break;
+                }
+                const W skip_bound =
+                    computeUpperBound(it + 1, end, value, budget_left);
+                if(!prunable(skip_bound, best_sol_value)) {
+                    _open_nodes.push_back(
+                        {skip_bound, value, budget_left,
+                         static_cast<std::uint32_t>(depth + 1), last_taken});
+                    std::push_heap(_open_nodes.begin(), _open_nodes.end(),
+                                   bound_less);
+                }
+                value += it->first;
                 budget_left -= it->second;
-                current_sol.push_back(it);
+                _taken_items.push_back(
+                    {last_taken, static_cast<std::uint32_t>(depth)});
+                last_taken =
+                    static_cast<std::uint32_t>(_taken_items.size() - 1);
+                _statistics.record_node(depth + 1);
             }
-            if(current_sol_value <= best_sol_value) continue;
-            best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+            if(value <= best_sol_value) continue;
+            best_sol_value = value;
+            collect_taken_items(last_taken, _best_sol);
+            _statistics.record_incumbent();
         }
+        return true;
     }
-    bool iterative_bnb_timeout(std::stop_token stoken) noexcept {
+
+    template <typename ST>
+    bool iterative_bnb(const ST & stoken) noexcept {
+        _statistics.start_solve();
         _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
-        const auto end = _value_cost_pairs.cend();
-        if(it == end) return true;
-        std::vector<decltype(it)> current_sol;
-        V current_sol_value = 0;
-        V best_sol_value = 0;
-        C budget_left = _budget;
-        goto begin;
-    backtrack:
-        while(!current_sol.empty() && !stoken.stop_requested()) {
-            it = current_sol.back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            current_sol.pop_back();
-            for(++it; it < end; ++it) {
-                if(budget_left < it->second) continue;
-                if(computeUpperBound(it, end, current_sol_value, budget_left) <=
-                   best_sol_value)
-                    goto backtrack;
-            begin:
-                current_sol_value += it->first;
-                budget_left -= it->second;
-                current_sol.push_back(it);
-            }
-            if(current_sol_value <= best_sol_value) continue;
-            best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+        _best_sol_value = _max_pruned_bound = _upper_bound = 0;
+        if(_value_cost_pairs.empty()) return true;
+        bool completed;
+        if(_strategy == search_strategy::best_first) {
+            completed = best_first_search(stoken);
+        } else {
+            _prefix_sol.resize(0);
+            completed =
+                depth_first_search(stoken, _value_cost_pairs.cbegin(), W{0},
+                                   _budget, _best_sol_value);
+        }
+        // an interrupted search only proves the root bound
+        if(completed) {
+            _upper_bound = std::max(_best_sol_value, _max_pruned_bound);
+        } else {
+            _upper_bound =
+                computeUpperBound(_value_cost_pairs.cbegin(),
+                                  _value_cost_pairs.cend(), W{0}, _budget);
+            if constexpr(std::floating_point<W>)
+                _upper_bound += std::abs(_upper_bound) * _bound_rounding_error;
         }
-        return current_sol.empty();
+        _statistics.stop_solve();
+        return completed;
     }
 
 public:
+    // All the solver memory is taken from 'resource', that may be a pool or
+    // a monotonic buffer reused from one solver to the next.
     knapsack_bnb(const C budget, const RI & items, const VM & value_map,
-                 const CM & cost_map) noexcept
-        : _budget(budget) {
+                 const CM & cost_map,
+                 std::pmr::memory_resource * resource =
+                     std::pmr::get_default_resource()) noexcept
+        : _budget(budget)
+        , _permuted_items(resource)
+        , _value_cost_pairs(resource)
+        , _best_sol(resource)
+        , _dfs(resource)
+        , _prefix_sol(resource)
+        , _strategy(search_strategy::depth_first)
+        , _max_nb_nodes(default_max_nb_nodes)
+        , _tolerance(0)
+        , _relative_gap(0.0)
+        , _bound_rounding_error(0)
+        , _best_sol_value(0)
+        , _max_pruned_bound(0)
+        , _upper_bound(0)
+        , _open_nodes(resource)
+        , _taken_items(resource) {
+        _statistics.start_preprocessing();
         if constexpr(std::ranges::sized_range<RI>) {
             _permuted_items.reserve(std::ranges::size(items));
             _value_cost_pairs.reserve(std::ranges::size(items));
@@ -140,34 +313,77 @@ public:
         ranges::sort(zip_view, [this](auto p1, auto p2) {
             return value_cost_ratio(p1.first) > value_cost_ratio(p2.first);
         });
+        _best_sol.reserve(_value_cost_pairs.size());
+        _dfs.reserve(_value_cost_pairs.size());
+        _prefix_sol.reserve(_value_cost_pairs.size());
+        // A bound sums at most n + 1 values and a ratio, each operation on
+        // non negative values adds a relative error of at most epsilon / 2.
+        if constexpr(std::floating_point<W>)
+            _bound_rounding_error =
+                static_cast<W>(_value_cost_pairs.size() + 2) *
+                std::numeric_limits<W>::epsilon();
+        _statistics.stop_preprocessing();
     }
 
-    void solve() noexcept { iterative_bnb(); }
+    // With search_strategy::best_first, the open nodes and the recorded
+    // paths are held in pools of at most max_nb_nodes entries.
+    void set_search_strategy(
+        const search_strategy strategy,
+        const std::size_t max_nb_nodes = default_max_nb_nodes) noexcept {
+        _strategy = strategy;
+        _max_nb_nodes = max_nb_nodes;
+    }
+
+    // Nodes whose bound does not exceed the incumbent value by more than
+    // 'tolerance' are pruned, the solution found is then within 'tolerance'
+    // of the optimum.
+    void set_tolerance(const V tolerance) noexcept {
+        _tolerance = static_cast<W>(tolerance);
+    }
+
+    // Nodes whose bound times (1 - relative_gap) does not exceed the
+    // incumbent value are pruned, the solution found is then worth at least
+    // (1 - relative_gap) times the optimum.
+    void set_relative_gap(const double relative_gap) noexcept {
+        _relative_gap = relative_gap;
+    }
+
+    void solve() noexcept { iterative_bnb(never_stop_token{}); }
+
+    // Returns false if the search was stopped by 'stoken' before completion
+    template <search_stop_token ST>
+    bool solve(const ST & stoken) noexcept {
+        return iterative_bnb(stoken);
+    }
 
+    // A timeout of zero waits for the search to complete
     template <typename _Rep, typename _Period>
     bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
-        if(timeout == timeout.zero()) {
-            solve();
-            return true;
-        }
-        std::jthread t([this](std::stop_token stoken) {
-            return iterative_bnb_timeout(stoken);
-        });
-        // C++23 should allow to call jthread from future and prevent launching
-        // the supplementary thread for join
-        auto future = std::async(std::launch::async, &std::jthread::join, &t);
-        if(future.wait_for(timeout) == std::future_status::timeout) {
-            t.request_stop();
-            return false;
-        }
-        return true;
+        if(timeout == timeout.zero()) return iterative_bnb(never_stop_token{});
+        return iterative_bnb(deadline_stop_token(timeout));
     }
 
     auto solution() const noexcept {
-        return std::ranges::views::transform(_best_sol, [this](auto && it) {
-            return _permuted_items[static_cast<std::size_t>(
-                std::distance(_value_cost_pairs.cbegin(), it))];
-        });
+        return std::ranges::views::transform(
+            _best_sol, [this](const item_index i) -> const I & {
+                return _permuted_items[i];
+            });
+    }
+
+    W solution_value() const noexcept { return _best_sol_value; }
+
+    // Upper bound on the optimum value proven by the last solve
+    W upper_bound() const noexcept { return _upper_bound; }
+
+    // Relative gap between the solution value and upper_bound()
+    double gap() const noexcept {
+        if(_upper_bound <= 0) return 0.0;
+        return static_cast<double>(_upper_bound - _best_sol_value) /
+               static_cast<double>(_upper_bound);
+    }
+
+    const bnb_statistics & statistics() const noexcept {
+        return _statistics.statistics();
     }
 };
 }  // namespace knapsack
@@ -2,9 +2,23 @@
 #define FHAMONIC_KNAPSACK_DYNAMIC_PROGRAMMING_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/cost_reduction.hpp"
+#include "knapsack/statistics.hpp"
 
 namespace fhamonic {
 namespace knapsack {
@@ -15,21 +29,204 @@ class knapsack_dp {
 public:
     using I = std::ranges::range_value_t<RI>;
     using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    // For integral values, the table entries are the narrowest integers
+    // holding every sum of item values, chosen at construction. Half width
+    // entries halve the memory traffic of the sweep, that dominates its time.
+    using table = std::conditional_t<
+        std::is_integral_v<V>,
+        std::variant<std::vector<std::int32_t>, std::vector<std::int64_t>,
+                     std::vector<widest_int>>,
+        std::variant<std::vector<V>>>;
 
     C _budget;
+    C _cost_divisor;
+    C _max_capacity;
     std::vector<I> _items;
     std::vector<std::pair<V, C>> _value_cost_pairs;
-    std::vector<V> _tab;
+    table _tab;
+    dp_statistics _statistics;
+
+    // The table is computed by tiles of tile_nb_items rows and
+    // tile_nb_capacities columns, small enough for a tile and the row above it
+    // to stay in L2 cache.
+    static constexpr std::size_t tile_nb_items = 8;
+    static constexpr std::size_t tile_nb_capacities = std::size_t{1} << 12;
+
+private:
+    std::size_t row_size() const noexcept {
+        return static_cast<std::size_t>(_budget) + 1;
+    }
+
+    // Column of the table for a capacity in the original cost unit
+    std::size_t column(const C capacity) const {
+        if(std::cmp_less(capacity, 0) || capacity > _max_capacity)
+            throw std::invalid_argument("knapsack_dp capacity out of range");
+        return static_cast<std::size_t>(
+            std::min(static_cast<C>(capacity / _cost_divisor), _budget));
+    }
+
+    template <typename T>
+    static bool holds(const widest_int min_value,
+                      const widest_int max_value) noexcept {
+        return min_value >= std::numeric_limits<T>::min() &&
+               max_value <= std::numeric_limits<T>::max();
+    }
+
+    // Throws std::length_error if the number of cells overflows std::size_t
+    void allocate_table() {
+        if(std::cmp_greater_equal(_budget,
+                                  std::numeric_limits<std::size_t>::max() /
+                                      (_items.size() + 1)))
+            throw std::length_error("knapsack_dp table too large");
+        const std::size_t nb_cells = (_items.size() + 1) * row_size();
+        if constexpr(std::is_integral_v<V>) {
+            // a cell is either the sum of the values of some items or this
+            // sum plus a non positive value
+            widest_int min_value = 0;
+            widest_int max_value = 0;
+            for(auto && p : _value_cost_pairs) {
+                const widest_int value = static_cast<widest_int>(p.first);
+                if(value > 0)
+                    max_value += value;
+                else
+                    min_value = std::min(min_value, value);
+            }
+            if(holds<std::int32_t>(min_value, max_value))
+                _tab.template emplace<0>(nb_cells);
+            else if(holds<std::int64_t>(min_value, max_value))
+                _tab.template emplace<1>(nb_cells);
+            else
+                _tab.template emplace<2>(nb_cells);
+        } else {
+            _tab.template emplace<0>(nb_cells);
+        }
+    }
+
+    // Computes the capacities [w_begin, w_end) of the row following the i-th
+    // item, reading only the row of the previous item.
+    template <typename T>
+    void compute_row(std::vector<T> & tab, const std::size_t i,
+                     const std::size_t w_begin,
+                     const std::size_t w_end) noexcept {
+        const T value = static_cast<T>(_value_cost_pairs[i].first);
+        const std::size_t c =
+            static_cast<std::size_t>(_value_cost_pairs[i].second);
+        const T * const previous_tab = tab.data() + i * row_size();
+        T * const current_tab = tab.data() + (i + 1) * row_size();
+        std::size_t w = std::clamp(c, w_begin, w_end);
+        std::copy(previous_tab + w_begin, previous_tab + w,
+                  current_tab + w_begin);
+        for(; w < w_end; ++w) {
+            current_tab[w] =
+                std::max(previous_tab[w], previous_tab[w - c] + value);
+        }
+    }
+
+    // Computes the capacities [w_begin, w_end) of the rows following the items
+    // [i_begin, i_end). Row i reads the capacities [w_begin - cost, w_end) of
+    // row i - 1, so the tiles at the left of [w_begin, w_end) must have been
+    // computed for the same items beforehand.
+    template <typename T>
+    void compute_tile(std::vector<T> & tab, const std::size_t i_begin,
+                      const std::size_t i_end, const std::size_t w_begin,
+                      const std::size_t w_end) noexcept {
+        for(std::size_t i = i_begin; i < i_end; ++i)
+            compute_row(tab, i, w_begin, w_end);
+    }
+
+    template <typename T>
+    void compute_table(std::vector<T> & tab) noexcept {
+        std::fill_n(tab.begin(), row_size(), T{0});
+        const std::size_t nb_items = _items.size();
+        for(std::size_t i = 0; i < nb_items; i += tile_nb_items) {
+            const std::size_t i_end = std::min(i + tile_nb_items, nb_items);
+            for(std::size_t w = 0; w < row_size(); w += tile_nb_capacities)
+                compute_tile(tab, i, i_end, w,
+                             std::min(w + tile_nb_capacities, row_size()));
+        }
+    }
+
+    // The tiles columns are dealt round robin to the threads. A tile only
+    // depends on the tiles at its left and above it, so each thread waits for
+    // the column at its left to be one tile ahead instead of synchronizing all
+    // threads at each row, the rows are computed as a pipeline.
+    template <typename T>
+    void parallel_compute_table(std::vector<T> & tab,
+                                const std::size_t nb_threads) {
+        const std::size_t nb_columns =
+            (row_size() + tile_nb_capacities - 1) / tile_nb_capacities;
+        std::fill_n(tab.begin(), row_size(), T{0});
+        const std::size_t nb_items = _items.size();
+        std::vector<std::atomic<std::size_t>> nb_rows_done(nb_columns);
+        auto worker = [&](const std::size_t first_column) {
+            for(std::size_t i = 0; i < nb_items; i += tile_nb_items) {
+                const std::size_t i_end = std::min(i + tile_nb_items, nb_items);
+                for(std::size_t column = first_column; column < nb_columns;
+                    column += nb_threads) {
+                    if(column > 0) {
+                        std::atomic<std::size_t> & left =
+                            nb_rows_done[column - 1];
+                        std::size_t done;
+                        while((done = left.load(std::memory_order_acquire)) <
+                              i_end)
+                            left.wait(done, std::memory_order_acquire);
+                    }
+                    const std::size_t w = column * tile_nb_capacities;
+                    compute_tile(tab, i, i_end, w,
+                                 std::min(w + tile_nb_capacities, row_size()));
+                    nb_rows_done[column].store(i_end,
+                                               std::memory_order_release);
+                    nb_rows_done[column].notify_one();
+                }
+            }
+        };
+        std::vector<std::jthread> threads;
+        threads.reserve(nb_threads - 1);
+        for(std::size_t t = 1; t < nb_threads; ++t)
+            threads.emplace_back(worker, t);
+        worker(0);
+    }
+
+    template <typename T>
+    std::vector<I> collect_solution(const std::vector<T> & tab,
+                                    const std::size_t w) const {
+        const std::size_t nb_items = _items.size();
+        const std::size_t budget = static_cast<std::size_t>(_budget);
+        std::vector<I> solution;
+        if(nb_items == 0) return solution;
+        const T * step = tab.data() + (nb_items * (budget + 1)) + w;
+
+        for(std::size_t i = (nb_items - 1); i > 0; --i) {
+            const bool taken = (*step > *(step - budget - 1));
+            if(taken) solution.push_back(_items[i]);
+            step -= budget + 1 +
+                    taken * static_cast<std::size_t>(
+                                _value_cost_pairs[i].second);
+        }
+        const bool taken = (*step > *(step - budget - 1));
+        if(taken) solution.push_back(_items[0]);
+
+        return solution;
+    }
 
 public:
+    // Allocates the (n + 1) * (budget + 1) cells of the table, throws
+    // std::invalid_argument if the budget is negative
     knapsack_dp(const C budget, const RI & items, const VM & value_map,
-                const CM & cost_map) noexcept
-        : _budget(budget) {
+                const CM & cost_map)
+        : _budget(budget)
+        , _max_capacity(budget) {
+        if(std::cmp_less(budget, 0))
+            throw std::invalid_argument("negative knapsack_dp budget");
+        std::chrono::steady_clock::time_point start_time;
+        if constexpr(enable_statistics)
+            start_time = std::chrono::steady_clock::now();
         if constexpr(std::ranges::sized_range<RI>) {
             const std::size_t nb_items = std::ranges::size(items);
             _items.reserve(nb_items);
             _value_cost_pairs.reserve(nb_items);
-            _tab.resize((nb_items + 1) * static_cast<std::size_t>(_budget + 1));
         }
 
         for(auto && i : items) {
@@ -40,41 +237,102 @@ public:
             _items.emplace_back(i);
             _value_cost_pairs.emplace_back(value, cost);
         }
+        const auto [reduced_budget, cost_divisor] = reduce_budget(
+            _budget, _value_cost_pairs, &std::pair<V, C>::second);
+        _budget = reduced_budget;
+        _cost_divisor = cost_divisor;
+        allocate_table();
+        if constexpr(enable_statistics)
+            _statistics.preprocessing_time =
+                std::chrono::steady_clock::now() - start_time;
     }
 
     void solve() {
-        V * previous_tab = _tab.data();
-        for(C w = 0; w < _budget; ++w) {
-            previous_tab[w] = 0;
+        std::chrono::steady_clock::time_point start_time;
+        if constexpr(enable_statistics) {
+            _statistics = dp_statistics{
+                .preprocessing_time = _statistics.preprocessing_time};
+            start_time = std::chrono::steady_clock::now();
+        }
+        std::visit([this](auto & tab) { compute_table(tab); }, _tab);
+        if constexpr(enable_statistics) {
+            _statistics.nb_cells = _items.size() * row_size();
+            _statistics.solve_time =
+                std::chrono::steady_clock::now() - start_time;
         }
+    }
 
-        for(const auto & [value, cost] : _value_cost_pairs) {
-            V * const current_tab = previous_tab + _budget + 1;
-            C w = std::min(_budget, cost);
-            std::copy(previous_tab, previous_tab + w, current_tab);
-            for(; w <= _budget; ++w) {
-                current_tab[w] =
-                    std::max(previous_tab[w], previous_tab[w - cost] + value);
-            }
-            previous_tab = current_tab;
+    void parallel_solve(
+        std::size_t nb_threads = std::thread::hardware_concurrency()) {
+        const std::size_t nb_columns =
+            (row_size() + tile_nb_capacities - 1) / tile_nb_capacities;
+        nb_threads = std::clamp(nb_threads, std::size_t{1}, nb_columns);
+        if(nb_threads == 1) {
+            solve();
+            return;
+        }
+        std::chrono::steady_clock::time_point start_time;
+        if constexpr(enable_statistics) {
+            _statistics = dp_statistics{
+                .preprocessing_time = _statistics.preprocessing_time};
+            start_time = std::chrono::steady_clock::now();
+        }
+        std::visit(
+            [this, nb_threads](auto & tab) {
+                parallel_compute_table(tab, nb_threads);
+            },
+            _tab);
+        if constexpr(enable_statistics) {
+            _statistics.nb_cells = _items.size() * row_size();
+            _statistics.solve_time =
+                std::chrono::steady_clock::now() - start_time;
         }
     }
 
-    auto solution() const noexcept {
-        const std::size_t nb_items = _items.size();
-        std::vector<I> solution;
-        const V * step = _tab.data() + (nb_items * (_budget + 1)) + _budget;
+    auto solution() const {
+        return std::visit(
+            [this](const auto & tab) {
+                return collect_solution(tab, static_cast<std::size_t>(_budget));
+            },
+            _tab);
+    }
 
-        for(std::size_t i = (nb_items - 1); i > 0; --i) {
-            const bool taken = (*step > *(step - _budget - 1));
-            if(taken) solution.push_back(_items[i]);
-            step -= _budget + 1 + taken * _value_cost_pairs[i].second;
-        }
-        const bool taken = (*step > *(step - _budget - 1));
-        if(taken) solution.push_back(_items[0]);
+    // The last row of the table holds the optimum for every capacity up to
+    // the budget, so after solve() the following queries only read it. They
+    // throw std::invalid_argument if a capacity does not lie between 0 and
+    // the budget given at construction.
+    W value_at(const C capacity) const {
+        const std::size_t w = column(capacity);
+        return std::visit(
+            [this, w](const auto & tab) {
+                return static_cast<W>(tab[_items.size() * row_size() + w]);
+            },
+            _tab);
+    }
 
-        return solution;
+    auto solution_at(const C capacity) const {
+        const std::size_t w = column(capacity);
+        return std::visit(
+            [this, w](const auto & tab) { return collect_solution(tab, w); },
+            _tab);
     }
+
+    template <std::ranges::input_range R>
+    std::vector<W> values_at(const R & capacities) const {
+        return std::visit(
+            [this, &capacities](const auto & tab) {
+                const auto * const last_row =
+                    tab.data() + _items.size() * row_size();
+                std::vector<W> values;
+                for(auto && capacity : capacities)
+                    values.push_back(static_cast<W>(last_row[column(
+                        static_cast<C>(capacity))]));
+                return values;
+            },
+            _tab);
+    }
+
+    const dp_statistics & statistics() const noexcept { return _statistics; }
 };
 
 }  // namespace knapsack
@@ -0,0 +1,145 @@
+#ifndef FHAMONIC_KNAPSACK_MEET_IN_THE_MIDDLE_HPP
+#define FHAMONIC_KNAPSACK_MEET_IN_THE_MIDDLE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Horowitz-Sahni meet in the middle for at most 64 items and arbitrary costs.
+// The subsets of each half of the items are enumerated into cost sorted lists
+// from which dominated subsets (costing more for no more value) are removed,
+// then the two lists are merged in linear time. The subsets are bitmasks, so
+// the constructor throws std::invalid_argument if more than 64 items are left
+// once those of zero value or costing more than the budget are discarded.
+template <typename C, typename RI, typename VM, typename CM>
+class knapsack_mitm {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    struct subset {
+        C cost;
+        W value;
+        std::uint64_t mask;
+    };
+
+    C _budget;
+    std::vector<I> _items;
+    std::vector<std::pair<V, C>> _value_cost_pairs;
+    std::uint64_t _best_sol;
+
+private:
+    // Subsets of the items [first, last) sorted by increasing cost and value,
+    // each doubling step merges the list with its copy including one more
+    // item and drops the subsets dominated by a cheaper one.
+    std::vector<subset> enumerate(const std::size_t first,
+                                  const std::size_t last) const {
+        std::vector<subset> subsets{{C{0}, W{0}, 0}};
+        std::vector<subset> merged;
+        for(std::size_t i = first; i < last; ++i) {
+            const auto & [value, cost] = _value_cost_pairs[i];
+            const std::uint64_t bit = std::uint64_t{1} << i;
+            merged.resize(0);
+            merged.reserve(2 * subsets.size());
+            auto without = subsets.cbegin();
+            auto with = subsets.cbegin();
+            const auto end = subsets.cend();
+            auto push = [&merged](const subset & s) {
+                if(!merged.empty() && s.value <= merged.back().value) return;
+                if(!merged.empty() && s.cost == merged.back().cost)
+                    merged.back() = s;
+                else
+                    merged.push_back(s);
+            };
+            while(with != end && _budget - with->cost >= cost) {
+                const subset s{with->cost + cost, with->value + value,
+                               with->mask | bit};
+                if(without != end && without->cost <= s.cost) {
+                    push(*without);
+                    ++without;
+                } else {
+                    push(s);
+                    ++with;
+                }
+            }
+            for(; without != end; ++without) push(*without);
+            subsets.swap(merged);
+        }
+        return subsets;
+    }
+
+    void merge(const std::vector<subset> & left,
+               const std::vector<subset> & right) noexcept {
+        W best_sol_value = 0;
+        _best_sol = 0;
+        auto r = right.crbegin();
+        for(const subset & l : left) {
+            while(r != right.crend() && _budget - l.cost < r->cost) ++r;
+            if(r == right.crend()) break;
+            if(l.value + r->value <= best_sol_value) continue;
+            best_sol_value = l.value + r->value;
+            _best_sol = l.mask | r->mask;
+        }
+    }
+
+public:
+    knapsack_mitm(const C budget, const RI & items, const VM & value_map,
+                  const CM & cost_map)
+        : _budget(budget)
+        , _best_sol(0) {
+        if constexpr(std::ranges::sized_range<RI>) {
+            _items.reserve(std::ranges::size(items));
+            _value_cost_pairs.reserve(std::ranges::size(items));
+        }
+
+        for(auto && i : items) {
+            const V value = value_map(i);
+            if(value == static_cast<V>(0)) continue;
+            const C cost = cost_map(i);
+            if(cost > _budget) continue;
+            _items.emplace_back(i);
+            _value_cost_pairs.emplace_back(value, cost);
+        }
+        if(_items.size() > 64)
+            throw std::invalid_argument(
+                "knapsack_mitm: more than 64 items of non zero value");
+    }
+
+    void solve() {
+        const std::size_t half = _items.size() / 2;
+        merge(enumerate(0, half), enumerate(half, _items.size()));
+    }
+
+    // Enumerates the two halves on two threads
+    void parallel_solve() {
+        const std::size_t half = _items.size() / 2;
+        std::vector<subset> left;
+        std::jthread t([this, &left, half] { left = enumerate(0, half); });
+        const std::vector<subset> right = enumerate(half, _items.size());
+        t.join();
+        merge(left, right);
+    }
+
+    auto solution() const noexcept {
+        std::vector<I> solution;
+        for(std::size_t i = 0; i < _items.size(); ++i)
+            if((_best_sol >> i) & 1) solution.push_back(_items[i]);
+        return solution;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_MEET_IN_THE_MIDDLE_HPP
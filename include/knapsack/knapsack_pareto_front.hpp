@@ -0,0 +1,282 @@
+#ifndef FHAMONIC_KNAPSACK_PARETO_FRONT_HPP
+#define FHAMONIC_KNAPSACK_PARETO_FRONT_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Nemhauser-Ullmann enumeration of the non dominated (cost, value) points of
+// the 0-1 knapsack, for the costs up to 'budget'. The front of the first i
+// items is merged with its copy shifted by the i-th item, dropping the
+// points that cost at least as much as another for no more value. Each point
+// records its predecessor in the previous front, so that its items are only
+// reconstructed when asked for.
+template <typename C, typename RI, typename VM, typename CM>
+class knapsack_pareto_front {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+public:
+    struct point {
+        C cost;
+        W value;
+    };
+
+    // Fronts smaller than this are merged by a single thread
+    static constexpr std::size_t min_parallel_front_size = std::size_t{1}
+                                                           << 15;
+
+private:
+    // A predecessor is the index of a point in the previous front, whose
+    // high bit tells if the item was added to it.
+    static constexpr std::uint32_t taken_flag = std::uint32_t{1} << 31;
+
+    C _budget;
+    std::vector<I> _items;
+    std::vector<std::pair<V, C>> _value_cost_pairs;
+    std::vector<point> _front;
+    std::vector<point> _next_front;
+    std::vector<std::uint32_t> _predecessors;
+    std::vector<std::size_t> _stage_offsets;
+    std::vector<std::vector<point>> _chunk_points;
+    std::vector<std::vector<std::uint32_t>> _chunk_predecessors;
+
+private:
+    // Calls 'push' on the points [a, a_end) of _front and on the points
+    // [b, b_end) shifted by the i-th item, by increasing cost.
+    template <typename P>
+    void merge(const std::size_t i, std::size_t a, const std::size_t a_end,
+               std::size_t b, const std::size_t b_end, P && push) const {
+        const auto & [value, cost] = _value_cost_pairs[i];
+        while(b < b_end) {
+            const point with{static_cast<C>(_front[b].cost + cost),
+                             static_cast<W>(_front[b].value + value)};
+            if(a < a_end && _front[a].cost <= with.cost) {
+                push(_front[a], static_cast<std::uint32_t>(a));
+                ++a;
+            } else {
+                push(with, static_cast<std::uint32_t>(b) | taken_flag);
+                ++b;
+            }
+        }
+        for(; a < a_end; ++a) push(_front[a], static_cast<std::uint32_t>(a));
+    }
+
+    static auto push_back_non_dominated(std::vector<point> & points,
+                                        std::vector<std::uint32_t> & preds) {
+        return [&points, &preds](const point & p, const std::uint32_t pred) {
+            if(!points.empty() && p.value <= points.back().value) return;
+            if(!points.empty() && p.cost == points.back().cost) {
+                points.back() = p;
+                preds.back() = pred;
+            } else {
+                points.push_back(p);
+                preds.push_back(pred);
+            }
+        };
+    }
+
+    // Index of the first point of _front that cannot take the i-th item
+    std::size_t nb_extendable_points(const std::size_t i) const noexcept {
+        const C cost = _value_cost_pairs[i].second;
+        return static_cast<std::size_t>(
+            std::ranges::partition_point(
+                _front,
+                [this, cost](const point & p) {
+                    return p.cost <= _budget - cost;
+                }) -
+            _front.begin());
+    }
+
+    void sequential_stage(const std::size_t i) {
+        _next_front.resize(0);
+        merge(i, 0, _front.size(), 0, nb_extendable_points(i),
+              push_back_non_dominated(_next_front, _predecessors));
+    }
+
+    // The costs are split in nb_chunks ranges, each merged by a thread. The
+    // points of a chunk can only be dominated by the points of the previous
+    // chunks, that have a larger value, so that the chunks are concatenated
+    // without their first points of value below the previous ones.
+    void parallel_stage(const std::size_t i, const std::size_t nb_chunks) {
+        const C cost = _value_cost_pairs[i].second;
+        const std::size_t nb_points = _front.size();
+        const std::size_t b_end = nb_extendable_points(i);
+        std::vector<std::size_t> a_bounds(nb_chunks + 1);
+        std::vector<std::size_t> b_bounds(nb_chunks + 1);
+        for(std::size_t k = 0; k < nb_chunks; ++k) {
+            a_bounds[k] = k * nb_points / nb_chunks;
+            const C chunk_cost = _front[a_bounds[k]].cost;
+            b_bounds[k] =
+                (k == 0) ? 0
+                         : static_cast<std::size_t>(
+                               std::partition_point(
+                                   _front.begin(),
+                                   _front.begin() +
+                                       static_cast<std::ptrdiff_t>(b_end),
+                                   [cost, chunk_cost](const point & p) {
+                                       return p.cost + cost < chunk_cost;
+                                   }) -
+                               _front.begin());
+        }
+        a_bounds[nb_chunks] = nb_points;
+        b_bounds[nb_chunks] = b_end;
+
+        _chunk_points.resize(nb_chunks);
+        _chunk_predecessors.resize(nb_chunks);
+        auto merge_chunk = [&](const std::size_t k) {
+            _chunk_points[k].resize(0);
+            _chunk_predecessors[k].resize(0);
+            merge(i, a_bounds[k], a_bounds[k + 1], b_bounds[k],
+                  b_bounds[k + 1],
+                  push_back_non_dominated(_chunk_points[k],
+                                          _chunk_predecessors[k]));
+        };
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(nb_chunks - 1);
+            for(std::size_t k = 1; k < nb_chunks; ++k)
+                threads.emplace_back(merge_chunk, k);
+            merge_chunk(0);
+        }
+
+        _next_front.resize(0);
+        for(std::size_t k = 0; k < nb_chunks; ++k) {
+            const auto & points = _chunk_points[k];
+            std::size_t first = 0;
+            if(!_next_front.empty())
+                first = static_cast<std::size_t>(
+                    std::ranges::partition_point(
+                        points,
+                        [max_value = _next_front.back().value](
+                            const point & p) { return p.value <= max_value; }) -
+                    points.begin());
+            _next_front.insert(_next_front.end(),
+                               points.begin() +
+                                   static_cast<std::ptrdiff_t>(first),
+                               points.end());
+            _predecessors.insert(
+                _predecessors.end(),
+                _chunk_predecessors[k].begin() +
+                    static_cast<std::ptrdiff_t>(first),
+                _chunk_predecessors[k].end());
+        }
+    }
+
+    // Computes the fronts of the first n - 1 items, the last front is merged
+    // by the caller
+    void compute_fronts(const std::size_t nb_threads) {
+        _front.assign(1, point{C{0}, W{0}});
+        _predecessors.resize(0);
+        _stage_offsets.resize(0);
+        for(std::size_t i = 0; i + 1 < _value_cost_pairs.size(); ++i) {
+            assert(_front.size() < taken_flag);
+            _stage_offsets.push_back(_predecessors.size());
+            if(nb_threads > 1 && _front.size() >= min_parallel_front_size)
+                parallel_stage(i, nb_threads);
+            else
+                sequential_stage(i);
+            _front.swap(_next_front);
+        }
+    }
+
+public:
+    knapsack_pareto_front(const C budget, const RI & items,
+                          const VM & value_map, const CM & cost_map)
+        : _budget(budget) {
+        if constexpr(std::ranges::sized_range<RI>) {
+            _items.reserve(std::ranges::size(items));
+            _value_cost_pairs.reserve(std::ranges::size(items));
+        }
+        for(auto && i : items) {
+            const V value = value_map(i);
+            if(value == static_cast<V>(0)) continue;
+            const C cost = cost_map(i);
+            if(cost > _budget) continue;
+            _items.emplace_back(i);
+            _value_cost_pairs.emplace_back(value, cost);
+        }
+    }
+
+    // Calls on_point(p, index) for every point of the front, by increasing
+    // cost, as the last merge finalizes them. The last front is not stored,
+    // 'index' identifies the point for solution().
+    template <typename F>
+        requires std::invocable<F, const point &, std::size_t>
+    void solve(F && on_point, const std::size_t nb_threads = 1) {
+        if(_value_cost_pairs.empty()) {
+            _front.assign(1, point{C{0}, W{0}});
+            _stage_offsets.resize(0);
+            on_point(_front.front(), std::size_t{0});
+            return;
+        }
+        compute_fronts(nb_threads);
+        assert(_front.size() < taken_flag);
+        _stage_offsets.push_back(_predecessors.size());
+        // the last accepted point is final once a costlier one is accepted
+        bool has_pending = false;
+        point pending;
+        std::uint32_t pending_pred = 0;
+        std::size_t nb_points = 0;
+        merge(_value_cost_pairs.size() - 1, 0, _front.size(), 0,
+              nb_extendable_points(_value_cost_pairs.size() - 1),
+              [&](const point & p, const std::uint32_t pred) {
+                  if(has_pending && p.value <= pending.value) return;
+                  if(has_pending && p.cost != pending.cost) {
+                      _predecessors.push_back(pending_pred);
+                      on_point(pending, nb_points++);
+                  }
+                  pending = p;
+                  pending_pred = pred;
+                  has_pending = true;
+              });
+        _predecessors.push_back(pending_pred);
+        on_point(pending, nb_points++);
+        _front.clear();
+        _front.shrink_to_fit();
+        _next_front.clear();
+        _next_front.shrink_to_fit();
+    }
+
+    // Computes and stores the whole front
+    void solve(const std::size_t nb_threads = 1) {
+        std::vector<point> front;
+        solve([&front](const point & p,
+                       std::size_t) { front.push_back(p); },
+              nb_threads);
+        _front.swap(front);
+    }
+
+    // Points of the front by increasing cost and value, after solve()
+    const std::vector<point> & front() const noexcept { return _front; }
+
+    // Items of the index-th point of the front
+    std::vector<I> solution(std::size_t index) const {
+        std::vector<I> solution;
+        for(std::size_t i = _stage_offsets.size(); i-- > 0;) {
+            const std::uint32_t pred = _predecessors[_stage_offsets[i] + index];
+            if(pred & taken_flag) solution.push_back(_items[i]);
+            index = pred & ~taken_flag;
+        }
+        return solution;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_PARETO_FRONT_HPP
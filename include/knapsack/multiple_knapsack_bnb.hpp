@@ -0,0 +1,376 @@
+#ifndef FHAMONIC_KNAPSACK_MULTIPLE_BRANCH_AND_BOUND_HPP
+#define FHAMONIC_KNAPSACK_MULTIPLE_BRANCH_AND_BOUND_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <range/v3/algorithm/sort.hpp>
+#include <range/v3/view/zip.hpp>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/fractional_knapsack.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 multiple knapsack, where each item is put in at most one of several
+// bins of their own budget, in the spirit of Pisinger's Mulknap. The items
+// are assigned one after the other, by decreasing value/cost ratio, to each
+// bin that can hold them or to none. At each node
+//  - the surrogate relaxation, a single knapsack of the undecided items with
+//    the sum of the bins budgets left, is solved by knapsack_bnb and bounds
+//    the node,
+//  - the bins are then filled one after the other, by increasing budget
+//    left, with the surrogate items of largest total cost, again with
+//    knapsack_bnb. If every surrogate item is placed, the node is solved,
+//    otherwise the placed items give an incumbent.
+// Bins of equal budget left lead to the same subproblems, so an item is only
+// tried in one of them.
+template <typename C, typename RI, typename VM, typename CM>
+class multiple_knapsack_bnb {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    using item_index = std::uint32_t;
+    using bin_index = std::uint32_t;
+    static constexpr bin_index no_bin = UINT32_MAX;
+
+    // Each search thread owns its state, the knapsack_bnb subroutines
+    // allocate from its pool.
+    struct search_state {
+        std::vector<C> budgets_left;
+        std::vector<bin_index> assignment;
+        std::vector<bin_index> heuristic_assignment;
+        std::vector<C> heuristic_budgets_left;
+        std::vector<item_index> surrogate_items;
+        std::vector<item_index> remaining_items;
+        C surrogate_budget;
+        std::vector<bin_index> bins_order;
+        std::pmr::unsynchronized_pool_resource resource;
+        bnb_statistics_recorder statistics;
+    };
+
+    std::vector<C> _budgets;
+    std::vector<I> _items;
+    std::vector<std::pair<V, C>> _value_cost_pairs;
+    std::size_t _nb_threads;
+
+    std::mutex _incumbent_mutex;
+    W _best_sol_value;
+    std::vector<bin_index> _best_sol;
+    bnb_statistics_recorder _statistics;
+
+private:
+    double value_cost_ratio(const std::pair<V, C> & p) const noexcept {
+        if constexpr(std::numeric_limits<float>::is_iec559) {
+            return static_cast<double>(p.first) / static_cast<double>(p.second);
+        } else {
+            return (p.second == 0) ? std::numeric_limits<double>::max()
+                                   : (static_cast<double>(p.first) /
+                                      static_cast<double>(p.second));
+        }
+    }
+
+    W best_sol_value() {
+        std::lock_guard lock(_incumbent_mutex);
+        return _best_sol_value;
+    }
+
+    void record_incumbent(const W value,
+                          const std::vector<bin_index> & assignment) {
+        std::lock_guard lock(_incumbent_mutex);
+        if(value <= _best_sol_value) return;
+        _best_sol_value = value;
+        _best_sol = assignment;
+        _statistics.record_incumbent();
+    }
+
+    // Collects the items from 'depth' on that fit in a bin into
+    // state.remaining_items and returns the LP bound of the surrogate
+    // relaxation, whose budget is stored in state.surrogate_budget
+    W surrogate_lp_bound(search_state & state, const std::size_t depth) const {
+        C total_budget = 0;
+        C max_budget = 0;
+        for(const C budget_left : state.budgets_left) {
+            if(budget_left <= 0) continue;
+            total_budget += budget_left;
+            max_budget = std::max(max_budget, budget_left);
+        }
+        state.surrogate_budget = total_budget;
+        state.remaining_items.resize(0);
+        for(std::size_t j = depth; j < _items.size(); ++j)
+            if(_value_cost_pairs[j].second <= max_budget)
+                state.remaining_items.push_back(static_cast<item_index>(j));
+        const auto [break_item, budget_rest] = fractional_partition(
+            state.remaining_items.begin(), state.remaining_items.end(),
+            total_budget,
+            [this](const item_index j) { return _value_cost_pairs[j].first; },
+            [this](const item_index j) { return _value_cost_pairs[j].second; });
+        W bound = 0;
+        for(auto it = state.remaining_items.begin(); it != break_item; ++it)
+            bound += _value_cost_pairs[*it].first;
+        if(break_item == state.remaining_items.end()) return bound;
+        const auto [value, cost] = _value_cost_pairs[*break_item];
+        return bound + static_cast<W>(static_cast<double>(budget_rest) *
+                                      static_cast<double>(value) /
+                                      static_cast<double>(cost));
+    }
+
+    // Solves the surrogate relaxation of state.remaining_items into
+    // state.surrogate_items and returns its value
+    W solve_surrogate(search_state & state) const {
+        knapsack_bnb surrogate(
+            state.surrogate_budget, state.remaining_items,
+            [this](const item_index j) { return _value_cost_pairs[j].first; },
+            [this](const item_index j) { return _value_cost_pairs[j].second; },
+            &state.resource);
+        surrogate.solve();
+        W value = 0;
+        state.surrogate_items.resize(0);
+        for(const item_index j : surrogate.solution()) {
+            state.surrogate_items.push_back(j);
+            value += _value_cost_pairs[j].first;
+        }
+        return value;
+    }
+
+    // Fills the bins with the surrogate items into
+    // state.heuristic_assignment, then the space left with the other items
+    // from 'depth' on by first fit. Returns whether all the surrogate items
+    // are placed and the value of the placed items.
+    std::pair<bool, W> split_surrogate(search_state & state,
+                                       const std::size_t depth) const {
+        state.heuristic_assignment = state.assignment;
+        state.heuristic_budgets_left = state.budgets_left;
+        state.bins_order.resize(state.budgets_left.size());
+        std::iota(state.bins_order.begin(), state.bins_order.end(),
+                  bin_index{0});
+        std::ranges::sort(state.bins_order, {}, [&state](const bin_index k) {
+            return state.budgets_left[k];
+        });
+        W placed_value = 0;
+        auto & remaining = state.remaining_items;
+        remaining = state.surrogate_items;
+        for(const bin_index k : state.bins_order) {
+            if(remaining.empty()) break;
+            if(state.budgets_left[k] < 0) continue;
+            const auto cost_map = [this](const item_index j) {
+                return _value_cost_pairs[j].second;
+            };
+            knapsack_bnb fill(state.budgets_left[k], remaining, cost_map,
+                              cost_map, &state.resource);
+            fill.solve();
+            for(const item_index j : fill.solution()) {
+                state.heuristic_assignment[j] = k;
+                state.heuristic_budgets_left[k] -= _value_cost_pairs[j].second;
+                placed_value += _value_cost_pairs[j].first;
+            }
+            std::erase_if(remaining, [&state, k](const item_index j) {
+                return state.heuristic_assignment[j] == k;
+            });
+        }
+        const bool all_placed = remaining.empty();
+        for(std::size_t j = depth; j < _items.size(); ++j) {
+            if(state.heuristic_assignment[j] != no_bin) continue;
+            const auto [value, cost] = _value_cost_pairs[j];
+            for(const bin_index k : state.bins_order) {
+                if(state.heuristic_budgets_left[k] < cost) continue;
+                state.heuristic_assignment[j] = k;
+                state.heuristic_budgets_left[k] -= cost;
+                placed_value += value;
+                break;
+            }
+        }
+        return {all_placed, placed_value};
+    }
+
+    template <typename ST>
+    bool explore(const ST & stoken, search_state & state,
+                 const std::size_t depth, const W value) {
+        if(stoken.stop_requested()) return false;
+        state.statistics.record_node(depth);
+        if(depth == _items.size()) {
+            record_incumbent(value, state.assignment);
+            return true;
+        }
+        const W best_value = best_sol_value();
+        if(value + surrogate_lp_bound(state, depth) <= best_value ||
+           value + solve_surrogate(state) <= best_value) {
+            state.statistics.record_pruned_node();
+            return true;
+        }
+        const auto [all_placed, placed_value] = split_surrogate(state, depth);
+        record_incumbent(value + placed_value, state.heuristic_assignment);
+        if(all_placed) return true;
+
+        const auto [item_value, item_cost] = _value_cost_pairs[depth];
+        for(const bin_index k : branching_bins(state, depth)) {
+            state.budgets_left[k] -= item_cost;
+            state.assignment[depth] = k;
+            const bool completed =
+                explore(stoken, state, depth + 1, value + item_value);
+            state.assignment[depth] = no_bin;
+            state.budgets_left[k] += item_cost;
+            if(!completed) return false;
+        }
+        return explore(stoken, state, depth + 1, value);
+    }
+
+    // Bins that can hold the item 'depth', one per distinct budget left
+    std::vector<bin_index> branching_bins(const search_state & state,
+                                          const std::size_t depth) const {
+        std::vector<bin_index> bins;
+        const C cost = _value_cost_pairs[depth].second;
+        for(bin_index k = 0; k < state.budgets_left.size(); ++k) {
+            if(state.budgets_left[k] < cost) continue;
+            if(std::ranges::any_of(bins, [&state, k](const bin_index l) {
+                   return state.budgets_left[l] == state.budgets_left[k];
+               }))
+                continue;
+            bins.push_back(k);
+        }
+        return bins;
+    }
+
+    // The subtrees of the root children are explored by _nb_threads threads,
+    // each polling its own copy of 'stoken'
+    template <typename ST>
+    bool run(const ST & stoken) {
+        _statistics.start_solve();
+        _best_sol_value = 0;
+        _best_sol.assign(_items.size(), no_bin);
+        search_state root;
+        root.budgets_left = _budgets;
+        root.assignment.assign(_items.size(), no_bin);
+        bool completed;
+        if(_nb_threads <= 1 || _items.empty()) {
+            completed = explore(stoken, root, 0, W{0});
+        } else {
+            std::vector<bin_index> children = branching_bins(root, 0);
+            children.push_back(no_bin);
+            std::atomic<std::size_t> next_child = 0;
+            std::atomic<bool> all_completed = true;
+            auto explore_children = [&] {
+                const ST thread_stoken = stoken;
+                search_state state;
+                state.budgets_left = _budgets;
+                state.assignment.assign(_items.size(), no_bin);
+                for(std::size_t c; (c = next_child++) < children.size();) {
+                    const bin_index k = children[c];
+                    W value = 0;
+                    if(k != no_bin) {
+                        state.budgets_left[k] -= _value_cost_pairs[0].second;
+                        state.assignment[0] = k;
+                        value = _value_cost_pairs[0].first;
+                    }
+                    if(!explore(thread_stoken, state, 1, value))
+                        all_completed = false;
+                    if(k != no_bin) {
+                        state.budgets_left[k] += _value_cost_pairs[0].second;
+                        state.assignment[0] = no_bin;
+                    }
+                }
+                std::lock_guard lock(_incumbent_mutex);
+                _statistics.add_nodes(state.statistics.statistics());
+            };
+            {
+                std::vector<std::jthread> threads;
+                for(std::size_t t = 1; t < _nb_threads; ++t)
+                    threads.emplace_back(explore_children);
+                explore_children();
+            }
+            completed = all_completed;
+        }
+        _statistics.add_nodes(root.statistics.statistics());
+        _statistics.stop_solve();
+        return completed;
+    }
+
+public:
+    // 'budgets' is a range of the bins budgets
+    template <typename RB>
+    multiple_knapsack_bnb(const RB & budgets, const RI & items,
+                          const VM & value_map, const CM & cost_map)
+        : _nb_threads(1), _best_sol_value(0) {
+        _statistics.start_preprocessing();
+        for(auto && budget : budgets) _budgets.push_back(budget);
+        if(!_budgets.empty())
+            for_each_profitable_item(
+                std::ranges::max(_budgets), items, value_map, cost_map,
+                [this](std::size_t, auto && i, const V value, const C cost) {
+                    _items.emplace_back(i);
+                    _value_cost_pairs.emplace_back(value, cost);
+                });
+        auto zip_view = ranges::view::zip(_value_cost_pairs, _items);
+        ranges::sort(zip_view, [this](auto p1, auto p2) {
+            return value_cost_ratio(p1.first) > value_cost_ratio(p2.first);
+        });
+        _statistics.stop_preprocessing();
+    }
+
+    // The subtrees of the first item assignments are explored by
+    // 'nb_threads' threads
+    void set_nb_threads(const std::size_t nb_threads) noexcept {
+        _nb_threads = std::max(nb_threads, std::size_t{1});
+    }
+
+    void solve() { run(never_stop_token{}); }
+
+    // Returns false if the search was stopped by 'stoken' before completion
+    template <search_stop_token ST>
+    bool solve(const ST & stoken) {
+        return run(stoken);
+    }
+
+    // A timeout of zero waits for the search to complete
+    template <typename _Rep, typename _Period>
+    bool solve(const std::chrono::duration<_Rep, _Period> & timeout) {
+        if(timeout == timeout.zero()) return run(never_stop_token{});
+        return run(deadline_stop_token(timeout));
+    }
+
+    // Pairs of the taken items and of the index of their bin in 'budgets'
+    auto solution() const {
+        return std::views::iota(std::size_t{0}, _best_sol.size()) |
+               std::views::filter([this](const std::size_t j) {
+                   return _best_sol[j] != no_bin;
+               }) |
+               std::views::transform([this](const std::size_t j) {
+                   return std::make_pair(
+                       _items[j], static_cast<std::size_t>(_best_sol[j]));
+               });
+    }
+
+    W solution_value() const noexcept { return _best_sol_value; }
+
+    const bnb_statistics & statistics() const noexcept {
+        return _statistics.statistics();
+    }
+};
+
+// The budget type is deduced from the range of the bins budgets
+template <typename RB, typename RI, typename VM, typename CM>
+multiple_knapsack_bnb(const RB &, const RI &, const VM &, const CM &)
+    -> multiple_knapsack_bnb<std::ranges::range_value_t<RB>, RI, VM, CM>;
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_MULTIPLE_BRANCH_AND_BOUND_HPP
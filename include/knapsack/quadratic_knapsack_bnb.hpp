@@ -0,0 +1,389 @@
+#ifndef FHAMONIC_KNAPSACK_QUADRATIC_BRANCH_AND_BOUND_HPP
+#define FHAMONIC_KNAPSACK_QUADRATIC_BRANCH_AND_BOUND_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/fractional_knapsack.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Quadratic knapsack, where the value of a solution is the sum of the values
+// of its items plus the profits of the pairs of items it takes. The pair
+// profits are given as (position1, position2, profit) triplets of positions
+// in 'items' and stored in compressed sparse rows over the items.
+//
+// The items are decided in a fixed order. For every undecided item j, the
+// search keeps incrementally, as items are fixed, its gain g_j, that is its
+// value plus its profits with the taken items, and its potential h_j, the
+// sum of its positive profits with the other undecided items. The upper
+// plane bound of a node is the Dantzig bound of the undecided items valued
+// g_j + h_j / 2, since each pair profit of a solution is counted twice in
+// the potentials of its items. The first incumbent is built greedily from
+// the gains and improved by add and swap moves.
+template <typename C, typename RI, typename VM, typename CM>
+class quadratic_knapsack_bnb {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    using item_index = std::uint32_t;
+
+    C _budget;
+    std::vector<I> _items;
+    std::vector<std::pair<V, C>> _value_cost_pairs;
+    // Row j of the pair profits lies in [_row_offsets[j], _row_offsets[j+1])
+    // sorted by neighbor, its neighbors after j start at _upper_offsets[j].
+    std::vector<std::size_t> _row_offsets;
+    std::vector<std::size_t> _upper_offsets;
+    std::vector<std::pair<item_index, V>> _pair_profits;
+
+    std::vector<W> _gains;
+    std::vector<W> _potentials;
+    std::vector<item_index> _candidates;
+    std::vector<item_index> _best_sol;
+    std::vector<item_index> _current_sol;
+    W _best_sol_value;
+    W _bound_rounding_error;
+    bnb_statistics_recorder _statistics;
+
+private:
+    static double ratio(const W value, const C cost) noexcept {
+        if(cost == 0) return std::numeric_limits<double>::infinity();
+        return static_cast<double>(value) / static_cast<double>(cost);
+    }
+
+    auto row(const std::size_t j) const noexcept {
+        return std::ranges::subrange(
+            _pair_profits.begin() +
+                static_cast<std::ptrdiff_t>(_row_offsets[j]),
+            _pair_profits.begin() +
+                static_cast<std::ptrdiff_t>(_row_offsets[j + 1]));
+    }
+
+    auto upper_row(const std::size_t j) const noexcept {
+        return std::ranges::subrange(
+            _pair_profits.begin() +
+                static_cast<std::ptrdiff_t>(_upper_offsets[j]),
+            _pair_profits.begin() +
+                static_cast<std::ptrdiff_t>(_row_offsets[j + 1]));
+    }
+
+    static W positive_part(const V profit) noexcept {
+        return profit > static_cast<V>(0) ? static_cast<W>(profit) : W{0};
+    }
+
+    void record_incumbent(const W value,
+                          const std::vector<item_index> & sol) {
+        _best_sol_value = value;
+        _best_sol.assign(sol.begin(), sol.end());
+        _statistics.record_incumbent();
+    }
+
+    // Greedy by gain to cost ratio, then first improvement add and swap
+    // moves, the gains with respect to the solution being kept up to date.
+    void local_search() {
+        const std::size_t n = _items.size();
+        std::vector<W> gains(n);
+        std::vector<bool> taken(n, false);
+        std::vector<item_index> sol;
+        for(std::size_t j = 0; j < n; ++j)
+            gains[j] = _value_cost_pairs[j].first;
+        W value = 0;
+        C budget_left = _budget;
+        auto set_taken = [&](const std::size_t j, const bool take) {
+            taken[j] = take;
+            if(take) {
+                value += gains[j];
+                budget_left -= _value_cost_pairs[j].second;
+                for(auto && [k, profit] : row(j)) gains[k] += profit;
+            } else {
+                value -= gains[j];
+                budget_left += _value_cost_pairs[j].second;
+                for(auto && [k, profit] : row(j)) gains[k] -= profit;
+            }
+        };
+        for(;;) {
+            std::size_t best = n;
+            for(std::size_t j = 0; j < n; ++j) {
+                if(taken[j] || gains[j] <= 0 ||
+                   _value_cost_pairs[j].second > budget_left)
+                    continue;
+                if(best == n ||
+                   ratio(gains[j], _value_cost_pairs[j].second) >
+                       ratio(gains[best], _value_cost_pairs[best].second))
+                    best = j;
+            }
+            if(best == n) break;
+            set_taken(best, true);
+        }
+        for(std::size_t nb_moves = 0; nb_moves < n; ++nb_moves) {
+            bool improved = false;
+            for(std::size_t j = 0; !improved && j < n; ++j) {
+                if(taken[j]) continue;
+                const C cost = _value_cost_pairs[j].second;
+                if(cost <= budget_left && gains[j] > 0) {
+                    set_taken(j, true);
+                    improved = true;
+                    break;
+                }
+                for(std::size_t i = 0; i < n; ++i) {
+                    if(!taken[i] || cost > budget_left +
+                                               _value_cost_pairs[i].second)
+                        continue;
+                    // j loses its profit with i when they are swapped
+                    W loss = gains[i];
+                    for(auto && [k, profit] : row(i))
+                        if(k == j) loss += profit;
+                    if(gains[j] <= loss) continue;
+                    set_taken(i, false);
+                    set_taken(j, true);
+                    improved = true;
+                    break;
+                }
+            }
+            if(!improved) break;
+        }
+        sol.resize(0);
+        for(std::size_t j = 0; j < n; ++j)
+            if(taken[j]) sol.push_back(static_cast<item_index>(j));
+        if(value > _best_sol_value) record_incumbent(value, sol);
+    }
+
+    // Twice the upper plane value of an undecided item, kept integral
+    W doubled_plane_value(const std::size_t j) const noexcept {
+        return 2 * _gains[j] + _potentials[j];
+    }
+
+    // Dantzig bound of the undecided items from 'depth' on, valued by their
+    // upper plane value
+    W upper_plane_bound(const std::size_t depth, const C budget_left) {
+        _candidates.resize(0);
+        for(std::size_t j = depth; j < _items.size(); ++j)
+            if(_value_cost_pairs[j].second <= budget_left &&
+               doubled_plane_value(j) > 0)
+                _candidates.push_back(static_cast<item_index>(j));
+        const auto [break_item, budget_rest] = fractional_partition(
+            _candidates.begin(), _candidates.end(), budget_left,
+            [this](const item_index j) { return doubled_plane_value(j); },
+            [this](const item_index j) { return _value_cost_pairs[j].second; });
+        W doubled_bound = 0;
+        for(auto it = _candidates.begin(); it != break_item; ++it)
+            doubled_bound += doubled_plane_value(*it);
+        if(break_item != _candidates.end())
+            doubled_bound += static_cast<W>(
+                static_cast<double>(budget_rest) *
+                ratio(doubled_plane_value(*break_item),
+                      _value_cost_pairs[*break_item].second));
+        return doubled_bound / 2;
+    }
+
+    bool prunable(W bound) const noexcept {
+        if constexpr(std::floating_point<W>)
+            bound += std::abs(bound) * _bound_rounding_error;
+        return bound <= _best_sol_value;
+    }
+
+    // Fixes the item 'depth', taken first then left
+    template <typename ST>
+    bool explore(const ST & stoken, const std::size_t depth, const W value,
+                 const C budget_left) {
+        if(stoken.stop_requested()) return false;
+        _statistics.record_node(depth);
+        if(value > _best_sol_value) record_incumbent(value, _current_sol);
+        if(depth == _items.size()) return true;
+        if(prunable(value + upper_plane_bound(depth, budget_left))) {
+            _statistics.record_pruned_node();
+            return true;
+        }
+        const C cost = _value_cost_pairs[depth].second;
+        const W gain = _gains[depth];
+        bool completed = true;
+        // a fixed item moves its profits from the potentials of its
+        // undecided neighbors to their gains if it is taken
+        for(auto && [k, profit] : upper_row(depth))
+            _potentials[k] -= positive_part(profit);
+        if(cost <= budget_left) {
+            for(auto && [k, profit] : upper_row(depth))
+                _gains[k] += static_cast<W>(profit);
+            _current_sol.push_back(static_cast<item_index>(depth));
+            completed = explore(stoken, depth + 1, value + gain,
+                                static_cast<C>(budget_left - cost));
+            _current_sol.pop_back();
+            for(auto && [k, profit] : upper_row(depth))
+                _gains[k] -= static_cast<W>(profit);
+        }
+        if(completed)
+            completed = explore(stoken, depth + 1, value, budget_left);
+        for(auto && [k, profit] : upper_row(depth))
+            _potentials[k] += positive_part(profit);
+        return completed;
+    }
+
+    template <typename ST>
+    bool run(const ST & stoken) {
+        _statistics.start_solve();
+        const std::size_t n = _items.size();
+        _best_sol.resize(0);
+        _best_sol_value = 0;
+        _current_sol.resize(0);
+        local_search();
+        _gains.resize(n);
+        _potentials.assign(n, W{0});
+        for(std::size_t j = 0; j < n; ++j) {
+            _gains[j] = _value_cost_pairs[j].first;
+            for(auto && [k, profit] : row(j))
+                _potentials[j] += positive_part(profit);
+        }
+        const bool completed = explore(stoken, 0, W{0}, _budget);
+        _statistics.stop_solve();
+        return completed;
+    }
+
+public:
+    // 'pair_profits' is a range of (position1, position2, profit) where the
+    // positions are indices in 'items', the profits of a same pair add up.
+    // Throws std::invalid_argument if a position is out of range.
+    template <typename RP>
+    quadratic_knapsack_bnb(const C budget, const RI & items,
+                           const VM & value_map, const CM & cost_map,
+                           const RP & pair_profits)
+        : _budget(budget), _best_sol_value(0), _bound_rounding_error(0) {
+        _statistics.start_preprocessing();
+
+        // items of non positive value are kept, their pairs may pay for them
+        constexpr std::size_t no_item = std::numeric_limits<std::size_t>::max();
+        std::vector<std::size_t> item_of_position;
+        for(auto && i : items) {
+            const C cost = cost_map(i);
+            if(cost > _budget) {
+                item_of_position.push_back(no_item);
+                continue;
+            }
+            item_of_position.push_back(_items.size());
+            _items.emplace_back(i);
+            _value_cost_pairs.emplace_back(value_map(i), cost);
+        }
+        const std::size_t n = _items.size();
+        std::vector<std::tuple<std::size_t, std::size_t, V>> pairs;
+        for(auto && [position1, position2, profit] : pair_profits) {
+            const std::size_t j = item_of_position[checked_position(
+                position1, item_of_position.size())];
+            const std::size_t k = item_of_position[checked_position(
+                position2, item_of_position.size())];
+            if(j == no_item || k == no_item || j == k) continue;
+            pairs.emplace_back(j, k, profit);
+            pairs.emplace_back(k, j, profit);
+        }
+
+        // the items are decided by decreasing upper plane ratio
+        std::vector<W> upper_plane_values(n);
+        for(std::size_t j = 0; j < n; ++j)
+            upper_plane_values[j] =
+                2 * static_cast<W>(_value_cost_pairs[j].first);
+        for(auto && [j, k, profit] : pairs)
+            upper_plane_values[j] += positive_part(profit);
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::ranges::stable_sort(order, [&](const std::size_t j,
+                                            const std::size_t k) {
+            return ratio(upper_plane_values[j], _value_cost_pairs[j].second) >
+                   ratio(upper_plane_values[k], _value_cost_pairs[k].second);
+        });
+        std::vector<std::size_t> rank(n);
+        for(std::size_t r = 0; r < n; ++r) rank[order[r]] = r;
+        std::vector<I> sorted_items;
+        std::vector<std::pair<V, C>> sorted_pairs;
+        for(const std::size_t j : order) {
+            sorted_items.push_back(_items[j]);
+            sorted_pairs.push_back(_value_cost_pairs[j]);
+        }
+        _items.swap(sorted_items);
+        _value_cost_pairs.swap(sorted_pairs);
+
+        for(auto & [j, k, profit] : pairs) {
+            j = rank[j];
+            k = rank[k];
+        }
+        std::ranges::sort(pairs);
+        _row_offsets.assign(n + 1, 0);
+        _pair_profits.reserve(pairs.size());
+        for(std::size_t p = 0; p < pairs.size();) {
+            const auto [j, k, profit] = pairs[p];
+            V sum = profit;
+            for(++p; p < pairs.size() && std::get<0>(pairs[p]) == j &&
+                     std::get<1>(pairs[p]) == k;
+                ++p)
+                sum += std::get<2>(pairs[p]);
+            _pair_profits.emplace_back(static_cast<item_index>(k), sum);
+            ++_row_offsets[j + 1];
+        }
+        std::partial_sum(_row_offsets.begin(), _row_offsets.end(),
+                         _row_offsets.begin());
+        _upper_offsets.resize(n);
+        for(std::size_t j = 0; j < n; ++j) {
+            _upper_offsets[j] = static_cast<std::size_t>(
+                std::ranges::partition_point(
+                    row(j),
+                    [j](auto && p) { return p.first <= j; }) -
+                _pair_profits.begin());
+        }
+        _candidates.reserve(n);
+        _best_sol.reserve(n);
+        _current_sol.reserve(n);
+        if constexpr(std::floating_point<W>)
+            _bound_rounding_error =
+                static_cast<W>(pairs.size() + n + 2) *
+                std::numeric_limits<W>::epsilon();
+        _statistics.stop_preprocessing();
+    }
+
+    void solve() { run(never_stop_token{}); }
+
+    // Returns false if the search was stopped by 'stoken' before completion
+    template <search_stop_token ST>
+    bool solve(const ST & stoken) {
+        return run(stoken);
+    }
+
+    // A timeout of zero waits for the search to complete
+    template <typename _Rep, typename _Period>
+    bool solve(const std::chrono::duration<_Rep, _Period> & timeout) {
+        if(timeout == timeout.zero()) return run(never_stop_token{});
+        return run(deadline_stop_token(timeout));
+    }
+
+    auto solution() const noexcept {
+        return std::ranges::views::transform(
+            _best_sol,
+            [this](const item_index i) -> const I & { return _items[i]; });
+    }
+
+    W solution_value() const noexcept { return _best_sol_value; }
+
+    const bnb_statistics & statistics() const noexcept {
+        return _statistics.statistics();
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_QUADRATIC_BRANCH_AND_BOUND_HPP
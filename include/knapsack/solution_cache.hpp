@@ -0,0 +1,256 @@
+#ifndef FHAMONIC_KNAPSACK_SOLUTION_CACHE_HPP
+#define FHAMONIC_KNAPSACK_SOLUTION_CACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <ostream>
+#include <ranges>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/unbounded_knapsack_bnb.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+struct cache_statistics {
+    std::size_t nb_hits = 0;
+    std::size_t nb_misses = 0;
+    std::size_t nb_evictions = 0;
+    std::size_t memory_used = 0;
+
+    double hit_rate() const noexcept {
+        const std::size_t nb_lookups = nb_hits + nb_misses;
+        return nb_lookups == 0 ? 0.0
+                               : static_cast<double>(nb_hits) /
+                                     static_cast<double>(nb_lookups);
+    }
+};
+
+inline std::ostream & write_json(std::ostream & os,
+                                 const cache_statistics & s) {
+    return os << "{\"nb_hits\":" << s.nb_hits
+              << ",\"nb_misses\":" << s.nb_misses
+              << ",\"nb_evictions\":" << s.nb_evictions
+              << ",\"memory_used\":" << s.memory_used
+              << ",\"hit_rate\":" << s.hit_rate() << '}';
+}
+
+// LRU cache of solutions keyed by the instance items sorted by value and
+// cost, so that permutations of the same items share their entry. The
+// memory taken by the entries is kept under max_memory bytes by evicting the
+// least recently used ones. It is not thread safe.
+template <typename V, typename C>
+class solution_cache {
+public:
+    // Positions of the taken items in the canonical order and number of
+    // times they are taken
+    using canonical_solution =
+        std::vector<std::pair<std::uint32_t, std::size_t>>;
+
+private:
+    struct entry {
+        std::uint64_t hash;
+        bool unbounded;
+        C budget;
+        std::vector<std::pair<V, C>> items;
+        canonical_solution solution;
+
+        std::size_t memory() const noexcept {
+            // the list and hash map nodes take about 6 more pointers
+            return sizeof(entry) + 6 * sizeof(void *) +
+                   items.capacity() * sizeof(std::pair<V, C>) +
+                   solution.capacity() *
+                       sizeof(typename canonical_solution::value_type);
+        }
+    };
+    using entry_iterator = typename std::list<entry>::iterator;
+
+    std::list<entry> _entries;  // most recently used first
+    std::unordered_multimap<std::uint64_t, entry_iterator> _index;
+    std::size_t _max_memory;
+    cache_statistics _statistics;
+
+private:
+    static std::uint64_t mix(std::uint64_t h) noexcept {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+
+    static std::uint64_t hash(const bool unbounded, const C budget,
+                              const std::vector<std::pair<V, C>> & items) {
+        std::uint64_t h = mix(std::hash<C>{}(budget) + unbounded);
+        for(auto && [value, cost] : items) {
+            h = mix(h ^ std::hash<V>{}(value));
+            h = mix(h ^ std::hash<C>{}(cost));
+        }
+        return h;
+    }
+
+    entry_iterator find(const std::uint64_t h, const bool unbounded,
+                        const C budget,
+                        const std::vector<std::pair<V, C>> & items) {
+        const auto [begin, end] = _index.equal_range(h);
+        for(auto it = begin; it != end; ++it) {
+            const entry & e = *it->second;
+            if(e.unbounded == unbounded && e.budget == budget &&
+               e.items == items)
+                return it->second;
+        }
+        return _entries.end();
+    }
+
+    void erase_least_recently_used() {
+        const entry_iterator last = std::prev(_entries.end());
+        const auto [begin, end] = _index.equal_range(last->hash);
+        for(auto it = begin; it != end; ++it) {
+            if(it->second != last) continue;
+            _index.erase(it);
+            break;
+        }
+        _statistics.memory_used -= last->memory();
+        _entries.erase(last);
+        ++_statistics.nb_evictions;
+    }
+
+public:
+    explicit solution_cache(const std::size_t max_memory)
+        : _max_memory(max_memory) {}
+
+    // Returns the taken items of 'items' and the number of times they are
+    // taken. On a miss, 'solver' is called with the budget and the items in
+    // canonical order and returns a canonical_solution.
+    template <typename RI, typename VM, typename CM, typename S>
+    auto solve(const bool unbounded, const C budget, const RI & items,
+               const VM & value_map, const CM & cost_map, S && solver) {
+        using I = std::ranges::range_value_t<RI>;
+        std::vector<I> original_items;
+        std::vector<std::pair<V, C>> pairs;
+        for(auto && i : items) {
+            original_items.emplace_back(i);
+            pairs.emplace_back(value_map(i), cost_map(i));
+        }
+        std::vector<std::uint32_t> permutation(pairs.size());
+        std::iota(permutation.begin(), permutation.end(), std::uint32_t{0});
+        std::ranges::sort(permutation, std::less<>{},
+                          [&pairs](const std::uint32_t i) { return pairs[i]; });
+        std::vector<std::pair<V, C>> canonical_items;
+        canonical_items.reserve(pairs.size());
+        for(const std::uint32_t i : permutation)
+            canonical_items.push_back(pairs[i]);
+
+        const std::uint64_t h = hash(unbounded, budget, canonical_items);
+        entry_iterator it = find(h, unbounded, budget, canonical_items);
+        if(it != _entries.end()) {
+            ++_statistics.nb_hits;
+            _entries.splice(_entries.begin(), _entries, it);
+        } else {
+            ++_statistics.nb_misses;
+            canonical_solution solution = solver(budget, canonical_items);
+            _entries.push_front({h, unbounded, budget,
+                                 std::move(canonical_items),
+                                 std::move(solution)});
+            it = _entries.begin();
+            _index.emplace(h, it);
+            _statistics.memory_used += it->memory();
+        }
+
+        std::vector<std::pair<I, std::size_t>> solution;
+        solution.reserve(it->solution.size());
+        for(auto && [position, count] : it->solution)
+            solution.emplace_back(original_items[permutation[position]],
+                                  count);
+        // an entry larger than the whole budget is only kept until now
+        while(_statistics.memory_used > _max_memory && !_entries.empty())
+            erase_least_recently_used();
+        return solution;
+    }
+
+    void clear() noexcept {
+        _entries.clear();
+        _index.clear();
+        _statistics.memory_used = 0;
+    }
+
+    const cache_statistics & statistics() const noexcept {
+        return _statistics;
+    }
+};
+
+// Solves the canonical instances of the cache with the given solver type
+template <template <typename...> typename Solver, typename V, typename C>
+typename solution_cache<V, C>::canonical_solution solve_canonical(
+    const C budget, const std::vector<std::pair<V, C>> & canonical_items) {
+    const auto positions = std::views::iota(
+        std::uint32_t{0}, static_cast<std::uint32_t>(canonical_items.size()));
+    const auto value_map = [&canonical_items](const std::uint32_t i) {
+        return canonical_items[i].first;
+    };
+    const auto cost_map = [&canonical_items](const std::uint32_t i) {
+        return canonical_items[i].second;
+    };
+    Solver<C, decltype(positions), decltype(value_map), decltype(cost_map)>
+        solver(budget, positions, value_map, cost_map);
+    solver.solve();
+    typename solution_cache<V, C>::canonical_solution solution;
+    for(auto && s : solver.solution()) {
+        if constexpr(std::is_same_v<std::remove_cvref_t<decltype(s)>,
+                                    std::uint32_t>)
+            solution.emplace_back(s, 1);
+        else
+            solution.emplace_back(s.first, s.second);
+    }
+    return solution;
+}
+
+template <typename V, typename C, typename RI, typename VM, typename CM>
+auto cached_knapsack_bnb(solution_cache<V, C> & cache,
+                         const std::type_identity_t<C> budget,
+                         const RI & items, const VM & value_map,
+                         const CM & cost_map) {
+    std::vector<std::ranges::range_value_t<RI>> solution;
+    for(auto && [i, count] :
+        cache.solve(false, budget, items, value_map, cost_map,
+                    solve_canonical<knapsack_bnb, V, C>))
+        solution.emplace_back(i);
+    return solution;
+}
+
+template <typename V, typename C, typename RI, typename VM, typename CM>
+auto cached_knapsack_dp(solution_cache<V, C> & cache,
+                        const std::type_identity_t<C> budget,
+                        const RI & items, const VM & value_map,
+                        const CM & cost_map) {
+    std::vector<std::ranges::range_value_t<RI>> solution;
+    for(auto && [i, count] :
+        cache.solve(false, budget, items, value_map, cost_map,
+                    solve_canonical<knapsack_dp, V, C>))
+        solution.emplace_back(i);
+    return solution;
+}
+
+template <typename V, typename C, typename RI, typename VM, typename CM>
+auto cached_unbounded_knapsack_bnb(solution_cache<V, C> & cache,
+                                   const std::type_identity_t<C> budget,
+                                   const RI & items, const VM & value_map,
+                                   const CM & cost_map) {
+    return cache.solve(true, budget, items, value_map, cost_map,
+                       solve_canonical<unbounded_knapsack_bnb, V, C>);
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_SOLUTION_CACHE_HPP
@@ -0,0 +1,137 @@
+#ifndef FHAMONIC_KNAPSACK_SOLVE_HPP
+#define FHAMONIC_KNAPSACK_SOLVE_HPP
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/fixed_point.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/subset_sum_dp.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+enum class solver_kind { branch_and_bound, dynamic_programming, subset_sum };
+
+// Pearson correlation between values and costs, strongly correlated
+// instances are the hard ones for the branch and bound.
+template <typename RI, typename VM, typename CM>
+double value_cost_correlation(const RI & items, const VM & value_map,
+                              const CM & cost_map) noexcept {
+    double n = 0, sv = 0, sc = 0, svv = 0, scc = 0, svc = 0;
+    for(auto && i : items) {
+        const double v = static_cast<double>(value_map(i));
+        const double c = static_cast<double>(cost_map(i));
+        n += 1;
+        sv += v;
+        sc += c;
+        svv += v * v;
+        scc += c * c;
+        svc += v * c;
+    }
+    const double var_v = n * svv - sv * sv;
+    const double var_c = n * scc - sc * sc;
+    if(var_v <= 0 || var_c <= 0) return 1.0;
+    return (n * svc - sv * sc) / std::sqrt(var_v * var_c);
+}
+
+// Whether every item is valued at its cost
+template <typename RI, typename VM, typename CM>
+bool is_subset_sum(const RI & items, const VM & value_map,
+                   const CM & cost_map) noexcept {
+    for(auto && i : items)
+        if(value_map(i) != cost_map(i)) return false;
+    return true;
+}
+
+template <typename C, typename RI, typename VM, typename CM>
+solver_kind select_solver(const C budget, const RI & items,
+                          const VM & value_map, const CM & cost_map) noexcept {
+    if constexpr(!std::integral<C>) {
+        return solver_kind::branch_and_bound;
+    } else {
+        constexpr std::size_t small_nb_items = 32;
+        constexpr std::size_t small_nb_cells = std::size_t{1} << 16;
+        constexpr std::size_t max_nb_cells = std::size_t{1} << 26;
+        constexpr double strong_correlation = 0.9;
+
+        if(budget < 0) return solver_kind::branch_and_bound;
+        const std::size_t nb_items =
+            static_cast<std::size_t>(std::ranges::distance(items));
+        if(nb_items <= small_nb_items) return solver_kind::branch_and_bound;
+        if(std::cmp_less_equal(budget, max_nb_cells) &&
+           is_subset_sum(items, value_map, cost_map))
+            return solver_kind::subset_sum;
+        // the number of cells would exceed max_nb_cells, compared before the
+        // product that may wrap around
+        if(std::cmp_greater_equal(budget, max_nb_cells / (nb_items + 1)))
+            return solver_kind::branch_and_bound;
+        const std::size_t nb_cells =
+            (nb_items + 1) * (static_cast<std::size_t>(budget) + 1);
+        if(nb_cells <= small_nb_cells) return solver_kind::dynamic_programming;
+        if(value_cost_correlation(items, value_map, cost_map) >=
+           strong_correlation)
+            return solver_kind::dynamic_programming;
+        return solver_kind::branch_and_bound;
+    }
+}
+
+template <typename C, typename RI, typename VM, typename CM>
+auto solve(const C budget, const RI & items, const VM & value_map,
+           const CM & cost_map) {
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    std::vector<I> solution;
+    if constexpr(std::floating_point<C> || std::floating_point<V>) {
+        // Decimal fixed point inputs are solved exactly on integers, which
+        // also lets small instances be solved by dynamic programming.
+        std::int64_t cost_scale = 1;
+        std::int64_t value_scale = 1;
+        if constexpr(std::floating_point<C>)
+            cost_scale = decimal_scale(items, cost_map);
+        if constexpr(std::floating_point<V>)
+            value_scale = decimal_scale(items, value_map);
+        if(budget >= 0 && cost_scale != 0 && value_scale != 0) {
+            const auto scaled_value_map = [&](const auto & i) {
+                return to_fixed_point(value_map(i), value_scale);
+            };
+            const auto scaled_cost_map = [&](const auto & i) {
+                return to_fixed_point(cost_map(i), cost_scale);
+            };
+            return solve(to_fixed_point_floor(budget, cost_scale), items,
+                         scaled_value_map, scaled_cost_map);
+        }
+    }
+    if constexpr(std::integral<C>) {
+        const solver_kind kind =
+            select_solver(budget, items, value_map, cost_map);
+        if(kind == solver_kind::dynamic_programming) {
+            auto dp = knapsack_dp(budget, items, value_map, cost_map);
+            dp.solve();
+            for(auto && i : dp.solution()) solution.emplace_back(i);
+            return solution;
+        }
+        if(kind == solver_kind::subset_sum) {
+            auto ss = subset_sum_dp(budget, items, cost_map);
+            ss.solve();
+            for(auto && i : ss.solution()) solution.emplace_back(i);
+            return solution;
+        }
+    }
+    auto bnb = knapsack_bnb(budget, items, value_map, cost_map);
+    bnb.solve();
+    for(auto && i : bnb.solution()) solution.emplace_back(i);
+    return solution;
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_SOLVE_HPP
@@ -0,0 +1,171 @@
+#ifndef FHAMONIC_KNAPSACK_STATIC_BRANCH_AND_BOUND_HPP
+#define FHAMONIC_KNAPSACK_STATIC_BRANCH_AND_BOUND_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "knapsack/accumulator.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack branch and bound for at most N <= 64 items, without any
+// dynamic allocation. The items are stored in std::array and solutions are
+// bitmasks over the indices of the items in the input range. Every member is
+// constexpr so that instances known at compile time can be solved there.
+// The constructor throws std::invalid_argument if the input range holds more
+// than N items.
+template <std::size_t N, typename V, typename C>
+    requires(N <= 64)
+class static_knapsack_bnb {
+private:
+    using W = accumulator_t<V>;
+
+    C _budget;
+    std::size_t _nb_items;
+    std::array<std::pair<V, C>, N> _value_cost_pairs;
+    std::array<std::uint8_t, N> _indices;
+    std::uint64_t _best_sol;
+
+private:
+    static constexpr double value_cost_ratio(
+        const std::pair<V, C> & p) noexcept {
+        if constexpr(std::numeric_limits<float>::is_iec559) {
+            return static_cast<double>(p.first) / static_cast<double>(p.second);
+        } else {
+            return (p.second == 0) ? std::numeric_limits<double>::max()
+                                   : (static_cast<double>(p.first) /
+                                      static_cast<double>(p.second));
+        }
+    }
+
+    // Insertion sort by decreasing ratio, which is as fast as a sorting
+    // network for such small N and stays usable in constant evaluation.
+    constexpr void sort_by_ratio() noexcept {
+        for(std::size_t i = 1; i < _nb_items; ++i) {
+            const auto p = _value_cost_pairs[i];
+            const auto index = _indices[i];
+            const double ratio = value_cost_ratio(p);
+            std::size_t j = i;
+            for(; j > 0 && value_cost_ratio(_value_cost_pairs[j - 1]) < ratio;
+                --j) {
+                _value_cost_pairs[j] = _value_cost_pairs[j - 1];
+                _indices[j] = _indices[j - 1];
+            }
+            _value_cost_pairs[j] = p;
+            _indices[j] = index;
+        }
+    }
+
+    constexpr W computeUpperBound(std::size_t depth, W bound_value,
+                                  C bound_budget_left) const noexcept {
+        for(; depth < _nb_items; ++depth) {
+            const auto & [value, cost] = _value_cost_pairs[depth];
+            if(bound_budget_left < cost)
+                return bound_value +
+                       static_cast<W>(static_cast<double>(bound_budget_left) *
+                                      static_cast<double>(value) /
+                                      static_cast<double>(cost));
+            bound_budget_left -= cost;
+            bound_value += value;
+        }
+        return bound_value;
+    }
+
+public:
+    template <typename RI, typename VM, typename CM>
+    constexpr static_knapsack_bnb(const C budget, const RI & items,
+                                  const VM & value_map, const CM & cost_map)
+        : _budget(budget)
+        , _nb_items(0)
+        , _value_cost_pairs()
+        , _indices()
+        , _best_sol(0) {
+        std::size_t index = 0;
+        for(auto && i : items) {
+            if(index >= N)
+                throw std::invalid_argument(
+                    "static_knapsack_bnb: more than N items");
+            const V value = std::invoke(value_map, i);
+            const C cost = std::invoke(cost_map, i);
+            if(value != static_cast<V>(0) && cost <= _budget) {
+                _value_cost_pairs[_nb_items] = std::make_pair(value, cost);
+                _indices[_nb_items] = static_cast<std::uint8_t>(index);
+                ++_nb_items;
+            }
+            ++index;
+        }
+        sort_by_ratio();
+    }
+
+    constexpr void solve() noexcept {
+        _best_sol = 0;
+        std::array<std::uint8_t, N> stack{};
+        std::size_t stack_size = 0;
+        std::uint64_t current_sol = 0;
+        std::size_t depth = 0;
+        W current_sol_value = 0;
+        W best_sol_value = 0;
+        C budget_left = _budget;
+        // same search as knapsack_bnb, without goto that is not allowed in
+        // constexpr functions before C++23
+        for(;;) {
+            bool pruned = false;
+            for(; depth < _nb_items; ++depth) {
+                const auto & [value, cost] = _value_cost_pairs[depth];
+                if(budget_left < cost) continue;
+                if(computeUpperBound(depth, current_sol_value, budget_left) <=
+                   best_sol_value) {
+                    pruned = true;
+                    break;
+                }
+                current_sol_value += value;
+                budget_left -= cost;
+                current_sol |= std::uint64_t{1} << _indices[depth];
+                stack[stack_size++] = static_cast<std::uint8_t>(depth);
+            }
+            if(!pruned && current_sol_value > best_sol_value) {
+                best_sol_value = current_sol_value;
+                _best_sol = current_sol;
+            }
+            if(stack_size == 0) break;
+            depth = stack[--stack_size];
+            current_sol_value -= _value_cost_pairs[depth].first;
+            budget_left += _value_cost_pairs[depth].second;
+            current_sol &= ~(std::uint64_t{1} << _indices[depth]);
+            ++depth;
+        }
+    }
+
+    // Bit i is set if the i-th item of the input range is taken
+    constexpr std::uint64_t solution_mask() const noexcept { return _best_sol; }
+
+    // Indices of the taken items in the input range
+    constexpr auto solution() const noexcept {
+        return std::views::iota(std::size_t{0}, N) |
+               std::views::filter([mask = _best_sol](const std::size_t i) {
+                   return ((mask >> i) & 1) != 0;
+               });
+    }
+};
+
+template <std::size_t N, typename C, typename RI, typename VM, typename CM>
+constexpr auto make_static_knapsack_bnb(const C budget, const RI & items,
+                                        const VM & value_map,
+                                        const CM & cost_map) {
+    using V = std::remove_cvref_t<
+        std::invoke_result_t<VM, std::ranges::range_value_t<RI>>>;
+    return static_knapsack_bnb<N, V, C>(budget, items, value_map, cost_map);
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_STATIC_BRANCH_AND_BOUND_HPP
@@ -0,0 +1,60 @@
+#ifndef FHAMONIC_KNAPSACK_STATISTICS_HPP
+#define FHAMONIC_KNAPSACK_STATISTICS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+namespace fhamonic {
+namespace knapsack {
+
+// Statistics are collected only when FHAMONIC_KNAPSACK_ENABLE_STATISTICS is
+// defined, every counter update is behind an 'if constexpr' so the solvers
+// hot loops are unchanged otherwise.
+#ifdef FHAMONIC_KNAPSACK_ENABLE_STATISTICS
+inline constexpr bool enable_statistics = true;
+#else
+inline constexpr bool enable_statistics = false;
+#endif
+
+struct bnb_statistics {
+    std::size_t nb_nodes = 0;
+    std::size_t nb_pruned_nodes = 0;
+    std::size_t max_depth = 0;
+    std::size_t nb_incumbent_updates = 0;
+    std::chrono::nanoseconds preprocessing_time{0};
+    std::chrono::nanoseconds time_to_first_incumbent{0};
+    std::chrono::nanoseconds time_to_best_incumbent{0};
+    std::chrono::nanoseconds solve_time{0};
+};
+
+struct dp_statistics {
+    std::size_t nb_cells = 0;
+    std::chrono::nanoseconds preprocessing_time{0};
+    std::chrono::nanoseconds solve_time{0};
+};
+
+inline std::ostream & write_json(std::ostream & os,
+                                 const bnb_statistics & s) {
+    return os << "{\"nb_nodes\":" << s.nb_nodes
+              << ",\"nb_pruned_nodes\":" << s.nb_pruned_nodes
+              << ",\"max_depth\":" << s.max_depth
+              << ",\"nb_incumbent_updates\":" << s.nb_incumbent_updates
+              << ",\"preprocessing_time_ns\":" << s.preprocessing_time.count()
+              << ",\"time_to_first_incumbent_ns\":"
+              << s.time_to_first_incumbent.count()
+              << ",\"time_to_best_incumbent_ns\":"
+              << s.time_to_best_incumbent.count()
+              << ",\"solve_time_ns\":" << s.solve_time.count() << '}';
+}
+
+inline std::ostream & write_json(std::ostream & os, const dp_statistics & s) {
+    return os << "{\"nb_cells\":" << s.nb_cells
+              << ",\"preprocessing_time_ns\":" << s.preprocessing_time.count()
+              << ",\"solve_time_ns\":" << s.solve_time.count() << '}';
+}
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_STATISTICS_HPP
@@ -0,0 +1,75 @@
+#ifndef FHAMONIC_KNAPSACK_STOP_TOKEN_HPP
+#define FHAMONIC_KNAPSACK_STOP_TOKEN_HPP
+
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+
+namespace fhamonic {
+namespace knapsack {
+
+// The branch and bound searches poll stop_requested() of such a token at
+// each backtrack and stop as soon as it returns true, leaving the best
+// solution found so far. std::stop_token is one, to stop a search from
+// another thread.
+template <typename ST>
+concept search_stop_token = requires(const ST & stoken) {
+    { stoken.stop_requested() } -> std::convertible_to<bool>;
+};
+
+struct never_stop_token {
+    constexpr bool stop_requested() const noexcept { return false; }
+};
+
+// Requests a stop once a deadline of the steady clock is passed. The clock
+// is only read every check_period polls, which bounds the overshoot to that
+// many nodes of the search, so that timeouts need neither a thread nor a
+// clock read per node. The poll count is not synchronized, so a token must
+// be polled by a single thread, concurrent searches poll their own copy.
+class deadline_stop_token {
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr std::uint32_t check_period = 1024;
+
+private:
+    clock::time_point _deadline;
+    mutable std::uint32_t _nb_polls;
+    mutable bool _expired;
+
+    template <typename _Rep, typename _Period>
+    static clock::time_point deadline_after(
+        const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
+        const clock::time_point now = clock::now();
+        // timeouts beyond the clock range never expire
+        if(std::chrono::duration<double>(timeout) >=
+           std::chrono::duration<double>(clock::time_point::max() - now))
+            return clock::time_point::max();
+        return now + std::chrono::ceil<clock::duration>(timeout);
+    }
+
+public:
+    explicit deadline_stop_token(const clock::time_point deadline) noexcept
+        : _deadline(deadline)
+        , _nb_polls(0)
+        , _expired(false) {}
+
+    template <typename _Rep, typename _Period>
+    explicit deadline_stop_token(
+        const std::chrono::duration<_Rep, _Period> & timeout) noexcept
+        : deadline_stop_token(deadline_after(timeout)) {}
+
+    bool stop_requested() const noexcept {
+        if(_expired) return true;
+        if(++_nb_polls < check_period) return false;
+        _nb_polls = 0;
+        _expired = clock::now() >= _deadline;
+        return _expired;
+    }
+
+    clock::time_point deadline() const noexcept { return _deadline; }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_STOP_TOKEN_HPP
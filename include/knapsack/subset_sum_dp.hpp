@@ -0,0 +1,129 @@
+#ifndef FHAMONIC_KNAPSACK_SUBSET_SUM_DYNAMIC_PROGRAMMING_HPP
+#define FHAMONIC_KNAPSACK_SUBSET_SUM_DYNAMIC_PROGRAMMING_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "knapsack/cost_reduction.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Knapsack where the value of each item is its cost, i.e. maximizing the total
+// cost not exceeding the budget. The reachable totals are kept in a bitset
+// updated by word-parallel shift-or, 64 capacities per operation instead of
+// one for knapsack_dp. The first item reaching each total is recorded. The
+// total minus the cost of that item was reached by a strictly earlier item,
+// which is enough to rebuild the solution.
+template <typename C, typename RI, typename CM>
+    requires std::integral<C>
+class subset_sum_dp {
+public:
+    using I = std::ranges::range_value_t<RI>;
+
+    C _budget;
+    C _cost_divisor;
+    std::vector<I> _items;
+    std::vector<C> _costs;
+    std::vector<std::uint64_t> _reachable;
+    std::vector<std::uint32_t> _first_item;
+    std::size_t _best_total;
+
+private:
+    static constexpr std::size_t word_size = 64;
+
+public:
+    subset_sum_dp(const C budget, const RI & items,
+                  const CM & cost_map) noexcept
+        : _budget(budget)
+        , _cost_divisor(1)
+        , _best_total(0) {
+        if constexpr(std::ranges::sized_range<RI>) {
+            _items.reserve(std::ranges::size(items));
+            _costs.reserve(std::ranges::size(items));
+        }
+
+        for(auto && i : items) {
+            const C cost = cost_map(i);
+            if(cost <= 0 || cost > _budget) continue;
+            _items.emplace_back(i);
+            _costs.emplace_back(cost);
+        }
+        const auto [reduced_budget, cost_divisor] =
+            reduce_budget(_budget, _costs);
+        _budget = reduced_budget;
+        _cost_divisor = cost_divisor;
+    }
+
+    void solve() {
+        const std::size_t budget = static_cast<std::size_t>(_budget);
+        const std::size_t nb_words = budget / word_size + 1;
+        _reachable.assign(nb_words, 0);
+        _first_item.assign(budget + 1, 0);
+        std::vector<std::uint64_t> next(nb_words);
+        _reachable[0] = 1;
+        std::size_t total_cost = 0;
+        for(std::size_t i = 0; i < _costs.size(); ++i) {
+            const std::size_t cost = static_cast<std::size_t>(_costs[i]);
+            const std::size_t word_shift = cost / word_size;
+            const std::size_t bit_shift = cost % word_size;
+            // no total above the sum of the previous costs can be reached
+            total_cost = std::min(total_cost + cost, budget);
+            const std::size_t end = total_cost / word_size + 1;
+            for(std::size_t w = word_shift; w < end; ++w) {
+                std::uint64_t shifted = _reachable[w - word_shift] << bit_shift;
+                if(bit_shift > 0 && w > word_shift)
+                    shifted |= _reachable[w - word_shift - 1] >>
+                               (word_size - bit_shift);
+                next[w] = _reachable[w] | shifted;
+            }
+            if(end == nb_words)
+                next[end - 1] &=
+                    ~std::uint64_t{0} >> (word_size - 1 - budget % word_size);
+            for(std::size_t w = word_shift; w < end; ++w) {
+                for(std::uint64_t added = next[w] & ~_reachable[w]; added;
+                    added &= added - 1)
+                    _first_item[w * word_size +
+                                static_cast<std::size_t>(
+                                    std::countr_zero(added))] =
+                        static_cast<std::uint32_t>(i);
+            }
+            std::copy(next.cbegin() + static_cast<std::ptrdiff_t>(word_shift),
+                      next.cbegin() + static_cast<std::ptrdiff_t>(end),
+                      _reachable.begin() +
+                          static_cast<std::ptrdiff_t>(word_shift));
+            if((_reachable[budget / word_size] >> (budget % word_size)) & 1)
+                break;
+        }
+        _best_total = budget;
+        while(((_reachable[_best_total / word_size] >>
+                (_best_total % word_size)) &
+               1) == 0)
+            --_best_total;
+    }
+
+    // Largest total cost not exceeding the budget
+    C solution_value() const noexcept {
+        return static_cast<C>(_best_total) * _cost_divisor;
+    }
+
+    auto solution() const noexcept {
+        std::vector<I> solution;
+        for(std::size_t total = _best_total; total > 0;) {
+            const std::uint32_t i = _first_item[total];
+            solution.push_back(_items[i]);
+            total -= static_cast<std::size_t>(_costs[i]);
+        }
+        return solution;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_SUBSET_SUM_DYNAMIC_PROGRAMMING_HPP
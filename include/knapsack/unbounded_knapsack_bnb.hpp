@@ -1,12 +1,14 @@
 #ifndef UBOUNDED_FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 #define UBOUNDED_FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 
+#include <algorithm>
 #include <chrono>
-#include <future>
+#include <concepts>
+#include <cstdint>
 #include <iterator>
+#include <memory_resource>
 #include <numeric>
 #include <ranges>
-#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -15,6 +17,11 @@
 #include <range/v3/view/transform.hpp>
 #include <range/v3/view/zip.hpp>
 
+#include "knapsack/accumulator.hpp"
+#include "knapsack/bnb_search.hpp"
+#include "knapsack/statistics.hpp"
+#include "knapsack/stop_token.hpp"
+
 namespace fhamonic {
 namespace knapsack {
 
@@ -23,96 +30,99 @@ class unbounded_knapsack_bnb {
 private:
     using I = std::ranges::range_value_t<RI>;
     using V = std::invoke_result_t<VM, I>;
+    using W = accumulator_t<V>;
+
+    // Solutions are stored as pairs of the index of an item in the sorted
+    // order and of the number of times it is taken, that fits in C when C is
+    // integral.
+    using item_index = std::uint32_t;
+    using item_count = typename std::conditional_t<
+        std::integral<C>, std::make_unsigned<C>,
+        std::type_identity<std::size_t>>::type;
 
     C _budget;
-    std::vector<I> _permuted_items;
-    std::vector<std::pair<V, C>> _value_cost_pairs;
-    std::vector<std::pair<typename std::vector<std::pair<V, C>>::const_iterator,
-                          std::size_t>>
-        _best_sol;
+    std::pmr::vector<I> _permuted_items;
+    std::pmr::vector<std::pair<V, C>> _value_cost_pairs;
+    std::pmr::vector<std::pair<item_index, item_count>> _best_sol;
+    std::pmr::vector<std::pair<item_index, item_count>> _current_sol;
+    bnb_statistics_recorder _statistics;
 
 private:
     double value_cost_ratio(const std::pair<V, C> & p) const noexcept {
         if constexpr(std::numeric_limits<float>::is_iec559) {
-            return p.first / static_cast<double>(p.second);
+            return static_cast<double>(p.first) / static_cast<double>(p.second);
         } else {
             return (p.second == 0) ? std::numeric_limits<double>::max()
-                                   : (p.first / static_cast<double>(p.second));
+                                   : (static_cast<double>(p.first) /
+                                      static_cast<double>(p.second));
         }
     }
 
-    auto iterative_bnb() noexcept {
+    template <typename ST>
+    bool iterative_bnb(const ST & stoken) noexcept {
+        _statistics.start_solve();
         _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
+        const auto begin = _value_cost_pairs.cbegin();
         const auto end = _value_cost_pairs.cend();
-        std::vector<std::pair<decltype(it), std::size_t>> current_sol;
-        V current_sol_value = 0;
-        V best_sol_value = 0;
-        C budget_left = _budget;
-        goto begin;
-    backtrack:
-        while(!current_sol.empty()) {
-            it = current_sol.back().first;
-            if(--current_sol.back().second == 0) current_sol.pop_back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            for(++it; it < end; ++it) {
-                if(budget_left < it->second) continue;
-                if(current_sol_value + budget_left * value_cost_ratio(*it) <=
-                   best_sol_value)
-                    goto backtrack;
-            begin:
-                const std::size_t nb_take =
-                    static_cast<std::size_t>(budget_left / it->second);
-                current_sol_value += static_cast<V>(nb_take) * it->first;
-                budget_left -= static_cast<C>(nb_take) * it->second;
-                current_sol.emplace_back(it, nb_take);
-            }
-            if(current_sol_value <= best_sol_value) continue;
-            best_sol_value = current_sol_value;
-            _best_sol = current_sol;
-        }
-        return _best_sol;
-    }
-
-    auto iterative_bnb_timeout(std::stop_token stoken) noexcept {
-        _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
-        const auto end = _value_cost_pairs.cend();
-        std::vector<std::pair<decltype(it), std::size_t>> current_sol;
-        V current_sol_value = 0;
-        V best_sol_value = 0;
+        auto it = begin;
+        if(it == end) return true;
+        auto & current_sol = _current_sol;
+        std::size_t nb_synced = 0;
+        current_sol.resize(0);
+        W current_sol_value = 0;
+        W best_sol_value = 0;
         C budget_left = _budget;
         goto begin;
     backtrack:
         while(!current_sol.empty() && !stoken.stop_requested()) {
-            it = current_sol.back().first;
+            nb_synced = std::min(nb_synced, current_sol.size() - 1);
+            it = begin + current_sol.back().first;
             if(--current_sol.back().second == 0) current_sol.pop_back();
             current_sol_value -= it->first;
             budget_left += it->second;
             for(++it; it < end; ++it) {
                 if(budget_left < it->second) continue;
-                if(current_sol_value + budget_left * value_cost_ratio(*it) <=
-                   best_sol_value)
+                if(static_cast<double>(current_sol_value) +
+                       static_cast<double>(budget_left) *
+                           value_cost_ratio(*it) <=
+                   static_cast<double>(best_sol_value)) {
+                    _statistics.record_pruned_node();
                     goto backtrack;
+                }
             begin:
-                const std::size_t nb_take =
-                    static_cast<std::size_t>(budget_left / it->second);
-                current_sol_value += static_cast<V>(nb_take) * it->first;
+                const item_count nb_take =
+                    static_cast<item_count>(budget_left / it->second);
+                current_sol_value += static_cast<W>(nb_take) * it->first;
                 budget_left -= static_cast<C>(nb_take) * it->second;
-                current_sol.emplace_back(it, nb_take);
+                current_sol.emplace_back(static_cast<item_index>(it - begin),
+                                         nb_take);
+                _statistics.record_node(current_sol.size());
             }
             if(current_sol_value <= best_sol_value) continue;
             best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+            _best_sol.resize(nb_synced);
+            _best_sol.insert(_best_sol.end(),
+                             current_sol.cbegin() +
+                                 static_cast<std::ptrdiff_t>(nb_synced),
+                             current_sol.cend());
+            nb_synced = current_sol.size();
+            _statistics.record_incumbent();
         }
-        return _best_sol;
+        _statistics.stop_solve();
+        return current_sol.empty();
     }
 
 public:
     unbounded_knapsack_bnb(const C budget, const RI & items,
-                           const VM & value_map, const CM & cost_map) noexcept
-        : _budget(budget) {
+                           const VM & value_map, const CM & cost_map,
+                           std::pmr::memory_resource * resource =
+                               std::pmr::get_default_resource()) noexcept
+        : _budget(budget)
+        , _permuted_items(resource)
+        , _value_cost_pairs(resource)
+        , _best_sol(resource)
+        , _current_sol(resource) {
+        _statistics.start_preprocessing();
         if constexpr(std::ranges::sized_range<RI>) {
             _permuted_items.reserve(std::ranges::size(items));
             _value_cost_pairs.reserve(std::ranges::size(items));
@@ -131,37 +141,36 @@ public:
         ranges::sort(zip_view, [this](auto p1, auto p2) {
             return value_cost_ratio(p1.first) > value_cost_ratio(p2.first);
         });
+        _best_sol.reserve(_value_cost_pairs.size());
+        _current_sol.reserve(_value_cost_pairs.size());
+        _statistics.stop_preprocessing();
+    }
+
+    void solve() noexcept { iterative_bnb(never_stop_token{}); }
+
+    // Returns false if the search was stopped by 'stoken' before completion
+    template <search_stop_token ST>
+    bool solve(const ST & stoken) noexcept {
+        return iterative_bnb(stoken);
     }
 
-    void solve() noexcept { iterative_bnb(); }
-    
+    // A timeout of zero waits for the search to complete
     template <typename _Rep, typename _Period>
     bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
-        if(timeout == timeout.zero()) {
-            solve();
-            return true;
-        }
-        std::jthread t([this](std::stop_token stoken) {
-            return iterative_bnb_timeout(stoken);
-        });
-        // C++23 should allow to call jthread from future and prevent launching
-        // the supplementary thread for join
-        auto future = std::async(std::launch::async, &std::jthread::join, &t);
-        if(future.wait_for(timeout) == std::future_status::timeout) {
-            t.request_stop();
-            return false;
-        }
-        return true;
+        if(timeout == timeout.zero()) return iterative_bnb(never_stop_token{});
+        return iterative_bnb(deadline_stop_token(timeout));
     }
 
     auto solution() const noexcept {
         return std::ranges::views::transform(_best_sol, [this](auto & p) {
-            return std::make_pair(
-                _permuted_items[static_cast<std::size_t>(
-                    std::distance(_value_cost_pairs.cbegin(), p.first))],
-                p.second);
+            return std::make_pair(_permuted_items[p.first],
+                                  static_cast<std::size_t>(p.second));
         });
     }
+
+    const bnb_statistics & statistics() const noexcept {
+        return _statistics.statistics();
+    }
 };
 
 }  // namespace knapsack
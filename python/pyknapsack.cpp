@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/solve.hpp"
+#include "knapsack/unbounded_knapsack_bnb.hpp"
+
+namespace py = pybind11;
+namespace knapsack = fhamonic::knapsack;
+
+namespace {
+
+// Without py::array::forcecast, the overloads whose dtypes match the arrays
+// are selected first and take them without conversion.
+template <typename T>
+using array = py::array_t<T, py::array::c_style>;
+
+// The items are the indices of the entries of the arrays, the solvers read
+// the values and costs directly from the NumPy buffers.
+template <typename V, typename C>
+struct buffer_instance {
+    const V * values;
+    const C * costs;
+    std::size_t nb_items;
+
+    auto items() const noexcept {
+        return std::views::iota(std::size_t{0}, nb_items);
+    }
+    auto value_map() const noexcept {
+        return [values = values](const std::size_t i) { return values[i]; };
+    }
+    auto cost_map() const noexcept {
+        return [costs = costs](const std::size_t i) { return costs[i]; };
+    }
+};
+
+template <typename V, typename C>
+buffer_instance<V, C> make_instance(const array<V> & values,
+                                    const array<C> & costs) {
+    if(values.ndim() != 1 || costs.ndim() != 1 ||
+       values.size() != costs.size())
+        throw std::invalid_argument(
+            "values and costs must be one dimensional arrays of the same size");
+    return {values.data(), costs.data(),
+            static_cast<std::size_t>(values.size())};
+}
+
+template <typename T>
+array<T> to_array(const std::vector<T> & v) {
+    array<T> a(static_cast<py::ssize_t>(v.size()));
+    std::copy(v.begin(), v.end(), a.mutable_data());
+    return a;
+}
+
+template <typename V, typename C>
+py::tuple solve_bnb(const array<V> & values, const array<C> & costs,
+                    const C budget, const double timeout,
+                    const bool best_first) {
+    const auto instance = make_instance(values, costs);
+    std::vector<std::int64_t> solution;
+    bool optimal;
+    {
+        py::gil_scoped_release release;
+        auto solver = knapsack::knapsack_bnb(
+            budget, instance.items(), instance.value_map(),
+            instance.cost_map());
+        if(best_first)
+            solver.set_search_strategy(knapsack::search_strategy::best_first);
+        optimal = solver.solve(std::chrono::duration<double>(timeout));
+        for(auto && i : solver.solution())
+            solution.push_back(static_cast<std::int64_t>(i));
+    }
+    return py::make_tuple(to_array(solution), optimal);
+}
+
+template <typename V, typename C>
+py::tuple solve_unbounded_bnb(const array<V> & values, const array<C> & costs,
+                              const C budget, const double timeout) {
+    const auto instance = make_instance(values, costs);
+    std::vector<std::int64_t> solution;
+    std::vector<std::int64_t> counts;
+    bool optimal;
+    {
+        py::gil_scoped_release release;
+        auto solver = knapsack::unbounded_knapsack_bnb(
+            budget, instance.items(), instance.value_map(),
+            instance.cost_map());
+        optimal = solver.solve(std::chrono::duration<double>(timeout));
+        for(auto && [i, count] : solver.solution()) {
+            solution.push_back(static_cast<std::int64_t>(i));
+            counts.push_back(static_cast<std::int64_t>(count));
+        }
+    }
+    return py::make_tuple(to_array(solution), to_array(counts), optimal);
+}
+
+template <typename V, typename C>
+array<std::int64_t> solve_dp(const array<V> & values, const array<C> & costs,
+                             const C budget) {
+    const auto instance = make_instance(values, costs);
+    std::vector<std::int64_t> solution;
+    {
+        py::gil_scoped_release release;
+        auto solver = knapsack::knapsack_dp(
+            budget, instance.items(), instance.value_map(),
+            instance.cost_map());
+        solver.solve();
+        for(auto && i : solver.solution())
+            solution.push_back(static_cast<std::int64_t>(i));
+    }
+    return to_array(solution);
+}
+
+// Solves the instances on nb_threads threads with the solver chosen by
+// knapsack::solve, the GIL is released for the whole batch.
+template <typename V, typename C>
+std::vector<array<std::int64_t>> solve_batch(
+    const std::vector<array<V>> & values, const std::vector<array<C>> & costs,
+    const std::vector<C> & budgets, std::size_t nb_threads) {
+    if(values.size() != costs.size() || values.size() != budgets.size())
+        throw std::invalid_argument(
+            "values, costs and budgets must have the same length");
+    std::vector<buffer_instance<V, C>> instances;
+    instances.reserve(values.size());
+    for(std::size_t k = 0; k < values.size(); ++k)
+        instances.push_back(make_instance(values[k], costs[k]));
+
+    std::vector<std::vector<std::int64_t>> solutions(instances.size());
+    if(!instances.empty()) {
+        py::gil_scoped_release release;
+        std::atomic<std::size_t> next_instance = 0;
+        auto worker = [&] {
+            for(std::size_t k; (k = next_instance.fetch_add(1)) <
+                               instances.size();) {
+                const auto & instance = instances[k];
+                for(auto && i :
+                    knapsack::solve(budgets[k], instance.items(),
+                                    instance.value_map(), instance.cost_map()))
+                    solutions[k].push_back(static_cast<std::int64_t>(i));
+            }
+        };
+        if(nb_threads == 0) nb_threads = std::thread::hardware_concurrency();
+        nb_threads = std::clamp(nb_threads, std::size_t{1}, instances.size());
+        std::vector<std::jthread> threads;
+        threads.reserve(nb_threads - 1);
+        for(std::size_t t = 1; t < nb_threads; ++t)
+            threads.emplace_back(worker);
+        worker();
+    }
+    std::vector<array<std::int64_t>> result;
+    result.reserve(solutions.size());
+    for(const auto & solution : solutions)
+        result.push_back(to_array(solution));
+    return result;
+}
+
+template <typename V, typename C>
+void bind_solvers(py::module_ & m) {
+    m.def("knapsack_bnb", &solve_bnb<V, C>, py::arg("values"),
+          py::arg("costs"), py::arg("budget"), py::arg("timeout") = 0.0,
+          py::arg("best_first") = false,
+          "0-1 knapsack branch and bound, returns the indices of the taken "
+          "items and whether the solution is proven optimal. A zero timeout "
+          "waits for the search to complete.");
+    m.def("unbounded_knapsack_bnb", &solve_unbounded_bnb<V, C>,
+          py::arg("values"), py::arg("costs"), py::arg("budget"),
+          py::arg("timeout") = 0.0,
+          "Unbounded knapsack branch and bound, returns the indices of the "
+          "taken items, the number of times each one is taken and whether the "
+          "solution is proven optimal.");
+    m.def("solve_batch", &solve_batch<V, C>, py::arg("values"),
+          py::arg("costs"), py::arg("budgets"), py::arg("nb_threads") = 0,
+          "Solves a list of 0-1 knapsack instances in parallel and returns "
+          "the indices of the taken items of each one.");
+}
+
+template <typename V>
+void bind_dp(py::module_ & m) {
+    m.def("knapsack_dp", &solve_dp<V, std::int64_t>, py::arg("values"),
+          py::arg("costs"), py::arg("budget"),
+          "0-1 knapsack dynamic programming for integer costs, returns the "
+          "indices of the taken items.");
+}
+
+}  // namespace
+
+PYBIND11_MODULE(pyknapsack, m) {
+    m.doc() = "Branch and bound and dynamic programming knapsack solvers";
+    bind_solvers<std::int64_t, std::int64_t>(m);
+    bind_solvers<double, double>(m);
+    bind_dp<std::int64_t>(m);
+    bind_dp<double>(m);
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <bit>
+#include <random>
+
+#include "knapsack/cardinality_knapsack_bnb.hpp"
+#include "knapsack/cardinality_knapsack_dp.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+int brute_force_value(const random_instance & instance,
+                      const std::size_t max_nb_items) {
+    int best_value = 0;
+    for_each_subset(instance, [&](const std::uint64_t subset) {
+        if(static_cast<std::size_t>(std::popcount(subset)) > max_nb_items ||
+           subset_cost(instance, subset) > instance.budget)
+            return;
+        best_value = std::max(best_value, subset_value(instance, subset));
+    });
+    return best_value;
+}
+
+template <typename R>
+std::size_t nb_items(R && solution) {
+    std::size_t count = 0;
+    for(auto && i : solution) {
+        static_cast<void>(i);
+        ++count;
+    }
+    return count;
+}
+
+TEST(CardinalityKnapsack, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 12)));
+        const std::size_t max_nb_items =
+            static_cast<std::size_t>(random_int(rng, 0, 6));
+        const int optimum = brute_force_value(instance, max_nb_items);
+
+        auto bnb = Knapsack::cardinality_knapsack_bnb(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), max_nb_items);
+        bnb.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         bnb.solution()),
+                  optimum);
+        EXPECT_LE(nb_items(bnb.solution()), max_nb_items);
+
+        auto dp = Knapsack::cardinality_knapsack_dp(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), max_nb_items);
+        dp.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         dp.solution()),
+                  optimum);
+        EXPECT_LE(nb_items(dp.solution()), max_nb_items);
+        EXPECT_EQ(dp.solution_value(), optimum);
+    }
+}
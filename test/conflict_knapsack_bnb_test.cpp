@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "knapsack/conflict_knapsack_bnb.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+using conflict = std::pair<std::size_t, std::size_t>;
+
+int brute_force_value(const random_instance & instance,
+                      const std::vector<conflict> & conflicts) {
+    int best_value = 0;
+    for_each_subset(instance, [&](const std::uint64_t subset) {
+        if(subset_cost(instance, subset) > instance.budget) return;
+        for(auto && [i, j] : conflicts)
+            if(i != j && is_taken(subset, i) && is_taken(subset, j)) return;
+        best_value = std::max(best_value, subset_value(instance, subset));
+    });
+    return best_value;
+}
+
+// Conflict graphs from empty to dense, with duplicates and self conflicts,
+// which are ignored
+TEST(ConflictKnapsackBNB, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        std::vector<conflict> conflicts;
+        if(instance.size() > 0) {
+            const int nb_conflicts =
+                random_int(rng, 0, static_cast<int>(instance.size() * 2));
+            const int last = static_cast<int>(instance.size()) - 1;
+            for(int k = 0; k < nb_conflicts; ++k)
+                conflicts.emplace_back(
+                    static_cast<std::size_t>(random_int(rng, 0, last)),
+                    static_cast<std::size_t>(random_int(rng, 0, last)));
+        }
+        auto solver = Knapsack::conflict_knapsack_bnb(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), conflicts);
+        solver.solve();
+        const int optimum = brute_force_value(instance, conflicts);
+        std::vector<bool> taken(instance.size(), false);
+        for(auto && i : solver.solution())
+            taken[static_cast<std::size_t>(i)] = true;
+        for(auto && [i, j] : conflicts)
+            EXPECT_FALSE(i != j && taken[i] && taken[j]);
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  optimum);
+    }
+}
+
+// Beyond 64 items the bitset rows span several words. Conflicts between the
+// items 2k and 2k + 1 make the optimum that of a multiple choice knapsack,
+// computed by dynamic programming on the budget.
+TEST(ConflictKnapsackBNB, Matching) {
+    std::mt19937 rng(2);
+    for(int t = 0; t < 5; ++t) {
+        const random_instance instance = make_random_instance(rng, 70);
+        std::vector<conflict> conflicts;
+        for(std::size_t k = 0; k + 1 < instance.size(); k += 2)
+            conflicts.emplace_back(k, k + 1);
+        std::vector<int> best(static_cast<std::size_t>(instance.budget) + 1,
+                              0);
+        for(auto && [i, j] : conflicts) {
+            const std::vector<int> previous = best;
+            for(std::size_t w = 0; w < best.size(); ++w) {
+                for(const std::size_t k : {i, j}) {
+                    const std::size_t cost =
+                        static_cast<std::size_t>(instance.costs[k]);
+                    if(cost <= w)
+                        best[w] = std::max(best[w], previous[w - cost] +
+                                                        instance.values[k]);
+                }
+            }
+        }
+        auto solver = Knapsack::conflict_knapsack_bnb(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), conflicts);
+        solver.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  best.back());
+    }
+}
+
+// Positions are indices in the items range
+TEST(ConflictKnapsackBnB, PositionOutOfRange) {
+    std::mt19937 rng(3);
+    const random_instance instance = make_random_instance(rng, 5);
+    const auto make_solver = [&](const std::vector<conflict> & conflicts) {
+        return Knapsack::conflict_knapsack_bnb(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), conflicts);
+    };
+    EXPECT_NO_THROW(make_solver({{0, 4}}));
+    EXPECT_THROW(make_solver({{0, 5}}), std::invalid_argument);
+    EXPECT_THROW(make_solver({{5, 0}}), std::invalid_argument);
+    const std::vector<std::pair<int, int>> negative{{-1, 0}};
+    EXPECT_THROW(Knapsack::conflict_knapsack_bnb(
+                     instance.budget, instance.items, instance.value_map(),
+                     instance.cost_map(), negative),
+                 std::invalid_argument);
+}
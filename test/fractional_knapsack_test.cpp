@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "knapsack/fractional_knapsack.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// LP optimum by taking the items of positive value by decreasing ratio
+double sorted_lp_value(const random_instance & instance) {
+    std::vector<std::size_t> indices(instance.size());
+    std::iota(indices.begin(), indices.end(), std::size_t{0});
+    const auto ratio = [&](const std::size_t i) {
+        return (instance.costs[i] == 0)
+                   ? std::numeric_limits<double>::infinity()
+                   : static_cast<double>(instance.values[i]) /
+                         static_cast<double>(instance.costs[i]);
+    };
+    std::ranges::sort(indices, [&](const std::size_t i, const std::size_t j) {
+        return ratio(i) > ratio(j);
+    });
+    double value = 0.0;
+    int budget_left = instance.budget;
+    for(const std::size_t i : indices) {
+        if(instance.values[i] <= 0) continue;
+        if(instance.costs[i] > budget_left)
+            return value + static_cast<double>(budget_left) *
+                               static_cast<double>(instance.values[i]) /
+                               static_cast<double>(instance.costs[i]);
+        budget_left -= instance.costs[i];
+        value += instance.values[i];
+    }
+    return value;
+}
+
+TEST(FractionalKnapsack, SortedLP) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 1000; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 40)));
+        const auto solution = Knapsack::fractional_knapsack(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map());
+        EXPECT_NEAR(solution.value, sorted_lp_value(instance), 1e-9);
+        EXPECT_GE(solution.break_fraction, 0.0);
+        EXPECT_LT(solution.break_fraction, 1.0);
+        if(solution.break_item.has_value()) {
+            const std::size_t i =
+                static_cast<std::size_t>(*solution.break_item);
+            EXPECT_NEAR(solution.value,
+                        static_cast<double>(solution.taken_value) +
+                            solution.break_fraction * instance.values[i],
+                        1e-9);
+        } else {
+            EXPECT_EQ(solution.value,
+                      static_cast<double>(solution.taken_value));
+        }
+    }
+}
+
+// The costs of the half of larger ratios sum beyond the range of int
+TEST(FractionalKnapsack, CostsOverflow) {
+    random_instance instance;
+    instance.budget = (1 << 30) + 5;
+    instance.values.assign(4, 4);
+    instance.costs.assign(4, 1 << 30);
+    instance.items = {0, 1, 2, 3};
+    const auto solution = Knapsack::fractional_knapsack(
+        instance.budget, instance.items, instance.value_map(),
+        instance.cost_map());
+    EXPECT_EQ(solution.taken_value, 4);
+    EXPECT_TRUE(solution.break_item.has_value());
+    EXPECT_NEAR(solution.value, 4.0, 1e-6);
+}
@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "knapsack/knapsack_bnb.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+TEST(KnapsackBNB, DepthFirst) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        auto solver = Knapsack::knapsack_bnb(instance.budget, instance.items,
+                                             instance.value_map(),
+                                             instance.cost_map());
+        solver.solve();
+        const int optimum = brute_force_value(instance);
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  optimum);
+        EXPECT_EQ(solver.solution_value(), optimum);
+    }
+}
+
+// Small node pools make the search fall back to depth first
+TEST(KnapsackBNB, BestFirst) {
+    std::mt19937 rng(2);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        const int optimum = brute_force_value(instance);
+        for(const std::size_t max_nb_nodes : {std::size_t{1} << 20,
+                                              std::size_t{20}}) {
+            auto solver = Knapsack::knapsack_bnb(
+                instance.budget, instance.items, instance.value_map(),
+                instance.cost_map());
+            solver.set_search_strategy(Knapsack::search_strategy::best_first,
+                                       max_nb_nodes);
+            solver.solve();
+            EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                             solver.solution()),
+                      optimum);
+        }
+    }
+}
+
+// The solution is within the relative gap of the optimum, which lies below
+// the proven upper bound
+TEST(KnapsackBNB, RelativeGap) {
+    std::mt19937 rng(3);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        const int optimum = brute_force_value(instance);
+        for(const double relative_gap : {0.0, 0.05, 0.3}) {
+            auto solver = Knapsack::knapsack_bnb(
+                instance.budget, instance.items, instance.value_map(),
+                instance.cost_map());
+            solver.set_relative_gap(relative_gap);
+            solver.solve();
+            const int value = checked_solution_value(
+                instance, instance.budget, solver.solution());
+            EXPECT_EQ(solver.solution_value(), value);
+            EXPECT_LE(value, optimum);
+            EXPECT_GE(static_cast<double>(value),
+                      (1.0 - relative_gap) * static_cast<double>(optimum));
+            EXPECT_GE(solver.upper_bound(), optimum);
+            EXPECT_LE(solver.gap(), relative_gap);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "knapsack_c.h"
+
+#include "random_instances.hpp"
+
+TEST(KnapsackC, BnB) {
+    std::mt19937 rng(1);
+    knapsack_context * context = knapsack_context_create();
+    ASSERT_NE(context, nullptr);
+    for(int t = 0; t < 100; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        const std::vector<std::int32_t> values(instance.values.begin(),
+                                               instance.values.end());
+        const std::vector<std::int32_t> costs(instance.costs.begin(),
+                                              instance.costs.end());
+        std::vector<std::uint32_t> solution(instance.size());
+        std::size_t solution_size = 0;
+        ASSERT_EQ(knapsack_bnb_i32(context, values.data(), costs.data(),
+                                   instance.size(), instance.budget, 0,
+                                   solution.data(), &solution_size, nullptr),
+                  KNAPSACK_OK);
+        solution.resize(solution_size);
+        EXPECT_EQ(checked_solution_value(instance, instance.budget, solution),
+                  brute_force_value(instance));
+    }
+    knapsack_context_destroy(context);
+}
+
+// Items of non positive cost could be taken infinitely many times
+TEST(KnapsackC, UnboundedNonPositiveCosts) {
+    const std::vector<std::int64_t> values{3, 5};
+    std::vector<std::uint32_t> solution(2);
+    std::vector<std::uint64_t> counts(2);
+    std::size_t solution_size = 0;
+    for(const std::vector<std::int64_t> & costs :
+        {std::vector<std::int64_t>{0, 2}, std::vector<std::int64_t>{-1, 2}})
+        EXPECT_EQ(unbounded_knapsack_bnb_i64(
+                      nullptr, values.data(), costs.data(), 2, 10, 0,
+                      solution.data(), counts.data(), &solution_size, nullptr),
+                  KNAPSACK_INVALID_ARGUMENT);
+
+    const std::vector<double> fractional_values{3, 5};
+    const std::vector<double> fractional_costs{0.5, 2};
+    ASSERT_EQ(unbounded_knapsack_bnb_f64(
+                  nullptr, fractional_values.data(), fractional_costs.data(),
+                  2, 2.0, 0, solution.data(), counts.data(), &solution_size,
+                  nullptr),
+              KNAPSACK_OK);
+    ASSERT_EQ(solution_size, 1);
+    EXPECT_EQ(solution[0], 0);
+    EXPECT_EQ(counts[0], 4);
+    const std::vector<double> zero_costs{0.0, 2};
+    EXPECT_EQ(unbounded_knapsack_bnb_f64(
+                  nullptr, fractional_values.data(), zero_costs.data(), 2, 2.0,
+                  0, solution.data(), counts.data(), &solution_size, nullptr),
+              KNAPSACK_INVALID_ARGUMENT);
+}
+
+TEST(KnapsackC, DP) {
+    std::mt19937 rng(2);
+    for(int t = 0; t < 100; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        const std::vector<std::int64_t> values(instance.values.begin(),
+                                               instance.values.end());
+        const std::vector<std::int64_t> costs(instance.costs.begin(),
+                                              instance.costs.end());
+        std::vector<std::uint32_t> solution(instance.size());
+        std::size_t solution_size = 0;
+        ASSERT_EQ(knapsack_dp_i64(values.data(), costs.data(), instance.size(),
+                                  instance.budget, solution.data(),
+                                  &solution_size),
+                  KNAPSACK_OK);
+        solution.resize(solution_size);
+        EXPECT_EQ(checked_solution_value(instance, instance.budget, solution),
+                  brute_force_value(instance));
+    }
+}
+
+// Tables of 2^28 cells or more are refused, also when the product of the
+// number of rows and columns wraps around
+TEST(KnapsackC, DPTableSize) {
+    const std::vector<std::int64_t> values{3, 5, 7};
+    const std::vector<std::int64_t> costs{2, 3, 4};
+    std::vector<std::uint32_t> solution(3);
+    std::size_t solution_size = 0;
+    const auto solve = [&](const std::int64_t budget) {
+        return knapsack_dp_i64(values.data(), costs.data(), 3, budget,
+                               solution.data(), &solution_size);
+    };
+    EXPECT_EQ(solve((std::int64_t{1} << 26) - 2), KNAPSACK_OK);
+    EXPECT_EQ(solve(std::int64_t{1} << 26), KNAPSACK_INVALID_ARGUMENT);
+    EXPECT_EQ(solve((std::int64_t{1} << 62) - 1), KNAPSACK_INVALID_ARGUMENT);
+    EXPECT_EQ(solve(-1), KNAPSACK_INVALID_ARGUMENT);
+    const std::vector<std::int64_t> negative_costs{2, -3, 4};
+    EXPECT_EQ(knapsack_dp_i64(values.data(), negative_costs.data(), 3, 10,
+                              solution.data(), &solution_size),
+              KNAPSACK_INVALID_ARGUMENT);
+}
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Runs the daemon on the requests given as lines of its standard input and
+// returns its responses, in order since a single worker solves them. The
+// solving times and the statistics are removed from the responses.
+std::vector<std::string> daemon_responses(
+    const std::vector<std::string> & requests,
+    const std::string & options = "") {
+    const std::filesystem::path input =
+        std::filesystem::temp_directory_path() / "knapsack_daemon_test.txt";
+    {
+        std::ofstream file(input);
+        for(const std::string & request : requests) file << request << '\n';
+    }
+    const std::string command = std::string(KNAPSACK_DAEMON_PATH) +
+                                " --threads 1 " + options + " < " +
+                                input.string();
+    std::vector<std::string> responses;
+    FILE * output = ::popen(command.c_str(), "r");
+    if(output == nullptr) return responses;
+    std::string response;
+    for(int c; (c = std::fgetc(output)) != EOF;) {
+        if(c != '\n') {
+            response.push_back(static_cast<char>(c));
+            continue;
+        }
+        const std::size_t time = response.find(",\"time_us\":");
+        if(time != std::string::npos)
+            response.erase(time, response.find(',', time + 1) - time);
+        const std::size_t statistics = response.find(",\"statistics\":");
+        if(statistics != std::string::npos)
+            response.erase(statistics,
+                           response.find('}', statistics) + 1 - statistics);
+        responses.push_back(response);
+        response.clear();
+    }
+    ::pclose(output);
+    std::filesystem::remove(input);
+    return responses;
+}
+
+TEST(KnapsackDaemon, Solvers) {
+    const auto responses = daemon_responses(
+        {"a bnb 10 3 7 3 8 4 9 6", "b best_first 10 3 7 3 8 4 9 6",
+         "c dp 10 3 7 3 8 4 9 6", "d auto 10 3 7 3 8 4 9 6",
+         "e unbounded 10 2 7 3 8 4"});
+    ASSERT_EQ(responses.size(), 5u);
+    const std::string solution = "\"optimal\":true,\"solution\":[1,2],";
+    EXPECT_EQ(responses[0], "{\"id\":\"a\"," + solution + "\"value\":17}");
+    EXPECT_EQ(responses[1], "{\"id\":\"b\"," + solution + "\"value\":17}");
+    EXPECT_EQ(responses[2], "{\"id\":\"c\",\"optimal\":true,"
+                            "\"solution\":[2,1],\"value\":17}");
+    EXPECT_EQ(responses[3], "{\"id\":\"d\"," + solution + "\"value\":17}");
+    EXPECT_EQ(responses[4], "{\"id\":\"e\",\"optimal\":true,"
+                            "\"solution\":[[0,2],[1,1]],\"value\":22}");
+}
+
+TEST(KnapsackDaemon, InvalidRequests) {
+    const auto responses = daemon_responses(
+        {"a\"b bnb 10 1 7 3", "a unknown 10 1 7 3", "b bnb -1 1 7 3",
+         "c bnb 10 2 7 3", "d bnb 10 1 7", "e bnb 10 1 7 -3",
+         "f unbounded 10 2 7 0 8 4", "g dp 100000000 2 7 3 8 4"});
+    ASSERT_EQ(responses.size(), 8u);
+    EXPECT_EQ(responses[0], "{\"id\":null,\"error\":\"invalid id\"}");
+    for(std::size_t i = 1; i < responses.size(); ++i)
+        EXPECT_EQ(responses[i], "{\"id\":\"" + std::string(1, "aabcdefg"[i]) +
+                                    "\",\"error\":\"invalid request\"}");
+}
+
+// The values of the solutions overflow std::int64_t. The unbounded search
+// takes its single item 10^18 times and then backtracks one copy at a time,
+// so it is stopped by the timeout.
+TEST(KnapsackDaemon, LargeValues) {
+    const auto responses = daemon_responses(
+        {"a bnb 10 2 9223372036854775807 5 9223372036854775807 5",
+         "b unbounded 1000000000000000000 1 4611686018427387904 1"},
+        "--timeout 0.05");
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_EQ(responses[0], "{\"id\":\"a\",\"optimal\":true,"
+                            "\"solution\":[0,1],"
+                            "\"value\":18446744073709551614}");
+    EXPECT_EQ(responses[1], "{\"id\":\"b\",\"optimal\":false,"
+                            "\"solution\":[[0,1000000000000000000]],"
+                            "\"value\":4611686018427387904000000000000000000}");
+}
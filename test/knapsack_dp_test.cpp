@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "knapsack/accumulator.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+TEST(KnapsackDP, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 12)));
+        auto solver = Knapsack::knapsack_dp(instance.budget, instance.items,
+                                            instance.value_map(),
+                                            instance.cost_map());
+        solver.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  brute_force_value(instance));
+    }
+}
+
+// Budgets of several tiles of capacities, so that the columns are split
+// among the threads
+TEST(KnapsackDP, ParallelSolve) {
+    std::mt19937 rng(2);
+    for(int t = 0; t < 20; ++t) {
+        const random_instance instance =
+            make_random_instance(rng, 12, 1000, 4000);
+        for(std::size_t nb_threads = 1; nb_threads <= 8; nb_threads *= 2) {
+            auto solver = Knapsack::knapsack_dp(
+                instance.budget, instance.items, instance.value_map(),
+                instance.cost_map());
+            solver.parallel_solve(nb_threads);
+            EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                             solver.solution()),
+                      brute_force_value(instance));
+        }
+    }
+}
+
+// Every capacity up to the budget is answered from the table of the budget,
+// also when the costs are divided by their gcd
+TEST(KnapsackDP, SubBudgetQueries) {
+    std::mt19937 rng(3);
+    for(int t = 0; t < 50; ++t) {
+        random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 10)));
+        if(t % 2 == 1) {
+            for(int & cost : instance.costs) cost *= 4;
+            instance.budget *= 4;
+        }
+        const int budget = instance.budget;
+        auto solver = Knapsack::knapsack_dp(budget, instance.items,
+                                            instance.value_map(),
+                                            instance.cost_map());
+        solver.solve();
+        std::vector<int> capacities;
+        for(int capacity = 0; capacity <= budget; ++capacity)
+            capacities.push_back(capacity);
+        const auto values = solver.values_at(capacities);
+        for(const int capacity : capacities) {
+            instance.budget = capacity;
+            const int optimum = brute_force_value(instance);
+            EXPECT_EQ(solver.value_at(capacity), optimum);
+            EXPECT_EQ(values[static_cast<std::size_t>(capacity)], optimum);
+            EXPECT_EQ(checked_solution_value(instance, capacity,
+                                             solver.solution_at(capacity)),
+                      optimum);
+        }
+    }
+}
+
+// The number of cells of the table would wrap around std::size_t
+TEST(KnapsackDP, TableSizeOverflow) {
+    const std::vector<int> items{0, 1, 2};
+    const auto value_map = [](const int i) { return std::int64_t{i + 1}; };
+    const auto cost_map = [](const int i) {
+        return (std::int64_t{1} << 62) + i;
+    };
+    EXPECT_THROW(Knapsack::knapsack_dp(std::numeric_limits<std::int64_t>::max(),
+                                       items, value_map, cost_map),
+                 std::length_error);
+    EXPECT_THROW(Knapsack::knapsack_dp(std::int64_t{-1}, items, value_map,
+                                       cost_map),
+                 std::invalid_argument);
+}
+
+// Capacities are checked against [0, budget] also when the costs are divided
+// by their gcd, that would otherwise clamp them to the last column
+TEST(KnapsackDP, CapacityOutOfRange) {
+    const std::vector<int> items{0, 1, 2};
+    const auto value_map = [](const int i) { return i + 1; };
+    const auto cost_map = [](const int i) { return 4 * (i + 1); };
+    auto solver = Knapsack::knapsack_dp(20, items, value_map, cost_map);
+    solver.solve();
+    EXPECT_EQ(solver.value_at(0), 0);
+    EXPECT_EQ(solver.value_at(20), 5);
+    EXPECT_THROW(solver.value_at(-1), std::invalid_argument);
+    EXPECT_THROW(solver.value_at(21), std::invalid_argument);
+    EXPECT_THROW(solver.solution_at(-4), std::invalid_argument);
+    EXPECT_THROW(solver.solution_at(24), std::invalid_argument);
+    EXPECT_THROW(solver.values_at(std::vector<int>{0, 21}),
+                 std::invalid_argument);
+    EXPECT_THROW(solver.values_at(std::vector<int>{-1}),
+                 std::invalid_argument);
+}
+
+// The table entries are int32, int64 or widest_int depending on the sum of
+// the values, which crosses INT32_MAX or INT64_MAX for large offsets. The
+// optimum is compared to the enumeration, summed in widest_int, and to the
+// branch and bound, whose accumulator is widest_int for int64 values.
+TEST(KnapsackDP, TableEntryWidths) {
+    using Knapsack::widest_int;
+    std::mt19937 rng(4);
+    const std::int64_t offsets[] = {0, std::int64_t{1} << 28,
+                                    std::int64_t{1} << 60};
+    std::size_t nb_tables[3] = {0, 0, 0};
+    for(const std::int64_t offset : offsets) {
+        for(int t = 0; t < 20; ++t) {
+            const random_instance instance = make_random_instance(rng, 12);
+            std::vector<std::int64_t> values;
+            for(const int value : instance.values)
+                values.push_back(offset + value);
+            const auto value_map = [&](const int i) {
+                return values[static_cast<std::size_t>(i)];
+            };
+            widest_int optimum = 0;
+            for_each_subset(instance, [&](const std::uint64_t subset) {
+                if(subset_cost(instance, subset) > instance.budget) return;
+                widest_int value = 0;
+                for(std::size_t i = 0; i < instance.size(); ++i)
+                    if(is_taken(subset, i)) value += values[i];
+                optimum = std::max(optimum, value);
+            });
+
+            // the items of cost above the budget are discarded beforehand
+            widest_int sum = 0;
+            for(std::size_t i = 0; i < instance.size(); ++i)
+                if(instance.costs[i] <= instance.budget) sum += values[i];
+            const std::size_t expected_width =
+                (sum <= std::numeric_limits<std::int32_t>::max())   ? 0
+                : (sum <= std::numeric_limits<std::int64_t>::max()) ? 1
+                                                                    : 2;
+            nb_tables[expected_width] += 1;
+
+            auto dp = Knapsack::knapsack_dp(instance.budget, instance.items,
+                                            value_map, instance.cost_map());
+            EXPECT_EQ(dp._tab.index(), expected_width);
+            dp.solve();
+            widest_int dp_value = 0;
+            for(const int i : dp.solution())
+                dp_value += values[static_cast<std::size_t>(i)];
+            EXPECT_TRUE(dp_value == optimum);
+            EXPECT_TRUE(dp.value_at(instance.budget) == optimum);
+
+            auto bnb = Knapsack::knapsack_bnb(instance.budget, instance.items,
+                                              value_map, instance.cost_map());
+            bnb.solve();
+            EXPECT_TRUE(bnb.solution_value() == optimum);
+        }
+    }
+    for(const std::size_t nb : nb_tables) EXPECT_GT(nb, 0u);
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include <stdexcept>
+
+#include "knapsack/knapsack_mitm.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+TEST(KnapsackMITM, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        const int optimum = brute_force_value(instance);
+        auto solver = Knapsack::knapsack_mitm(instance.budget, instance.items,
+                                              instance.value_map(),
+                                              instance.cost_map());
+        solver.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  optimum);
+        solver.parallel_solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  optimum);
+    }
+}
+
+// The subsets are 64 bits masks
+TEST(KnapsackMITM, TooManyItems) {
+    std::mt19937 rng(2);
+    random_instance instance = make_random_instance(rng, 65, 50, 0);
+    for(int & value : instance.values) value += 1;
+    EXPECT_THROW(Knapsack::knapsack_mitm(instance.budget, instance.items,
+                                         instance.value_map(),
+                                         instance.cost_map()),
+                 std::invalid_argument);
+    instance.values[0] = 0;
+    EXPECT_NO_THROW(Knapsack::knapsack_mitm(instance.budget, instance.items,
+                                            instance.value_map(),
+                                            instance.cost_map()));
+}
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "knapsack/knapsack_pareto_front.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// (cost, value) points of the subsets fitting the budget that no other
+// subset reaches for a lower or equal cost
+std::vector<std::pair<int, int>> brute_force_front(
+    const random_instance & instance) {
+    std::vector<std::pair<int, int>> points;
+    for_each_subset(instance, [&](const std::uint64_t subset) {
+        const int cost = subset_cost(instance, subset);
+        if(cost <= instance.budget)
+            points.emplace_back(cost, subset_value(instance, subset));
+    });
+    std::ranges::sort(points, [](const auto & p1, const auto & p2) {
+        return p1.first < p2.first ||
+               (p1.first == p2.first && p1.second > p2.second);
+    });
+    std::vector<std::pair<int, int>> front;
+    for(const auto & p : points)
+        if(front.empty() || p.second > front.back().second)
+            front.push_back(p);
+    return front;
+}
+
+TEST(KnapsackParetoFront, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 200; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 12)));
+        const auto expected_front = brute_force_front(instance);
+        auto solver = Knapsack::knapsack_pareto_front(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map());
+        solver.solve();
+        ASSERT_EQ(solver.front().size(), expected_front.size());
+        for(std::size_t k = 0; k < expected_front.size(); ++k) {
+            const auto & p = solver.front()[k];
+            EXPECT_EQ(p.cost, expected_front[k].first);
+            EXPECT_EQ(p.value, expected_front[k].second);
+            EXPECT_EQ(checked_solution_value(instance, p.cost,
+                                             solver.solution(k)),
+                      expected_front[k].second);
+        }
+    }
+}
+
+// The points passed to the callback are those of the stored front
+TEST(KnapsackParetoFront, Callback) {
+    std::mt19937 rng(2);
+    for(int t = 0; t < 100; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 12)));
+        const auto expected_front = brute_force_front(instance);
+        auto solver = Knapsack::knapsack_pareto_front(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map());
+        std::vector<std::pair<int, int>> front;
+        solver.solve([&](const auto & p, const std::size_t index) {
+            EXPECT_EQ(index, front.size());
+            front.emplace_back(p.cost, p.value);
+        });
+        EXPECT_EQ(front, expected_front);
+        for(std::size_t k = 0; k < front.size(); ++k)
+            EXPECT_EQ(checked_solution_value(instance, front[k].first,
+                                             solver.solution(k)),
+                      front[k].second);
+    }
+}
+
+// Values close to the costs give fronts large enough to be merged by
+// several threads
+TEST(KnapsackParetoFront, Parallel) {
+    std::mt19937 rng(3);
+    random_instance instance = make_random_instance(rng, 40, 100, 100000);
+    for(std::size_t i = 0; i < instance.size(); ++i)
+        instance.values[i] = instance.costs[i] + random_int(rng, 0, 100);
+    auto sequential = Knapsack::knapsack_pareto_front(
+        instance.budget, instance.items, instance.value_map(),
+        instance.cost_map());
+    sequential.solve();
+    auto parallel = Knapsack::knapsack_pareto_front(
+        instance.budget, instance.items, instance.value_map(),
+        instance.cost_map());
+    parallel.solve(4);
+    ASSERT_GE(sequential.front().size(),
+              decltype(sequential)::min_parallel_front_size);
+    ASSERT_EQ(parallel.front().size(), sequential.front().size());
+    for(std::size_t k = 0; k < sequential.front().size(); ++k) {
+        EXPECT_EQ(parallel.front()[k].cost, sequential.front()[k].cost);
+        EXPECT_EQ(parallel.front()[k].value, sequential.front()[k].value);
+    }
+}
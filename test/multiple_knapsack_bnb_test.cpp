@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "knapsack/multiple_knapsack_bnb.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// Enumerates the (nb_bins + 1)^nb_items assignments of the items to a bin
+// or to none. Bins of negative budget can only stay empty.
+int brute_force_value(const random_instance & instance,
+                      const std::vector<int> & budgets) {
+    const std::size_t nb_choices = budgets.size() + 1;
+    std::size_t nb_assignments = 1;
+    for(std::size_t i = 0; i < instance.size(); ++i)
+        nb_assignments *= nb_choices;
+    int best_value = 0;
+    for(std::size_t assignment = 0; assignment < nb_assignments;
+        ++assignment) {
+        std::vector<int> budgets_left = budgets;
+        int value = 0;
+        bool feasible = true;
+        std::size_t code = assignment;
+        for(std::size_t i = 0; i < instance.size(); ++i, code /= nb_choices) {
+            const std::size_t bin = code % nb_choices;
+            if(bin == budgets.size()) continue;
+            budgets_left[bin] -= instance.costs[i];
+            value += instance.values[i];
+            feasible = feasible && budgets_left[bin] >= 0;
+        }
+        if(feasible) best_value = std::max(best_value, value);
+    }
+    return best_value;
+}
+
+TEST(MultipleKnapsackBNB, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 200; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 8)));
+        std::vector<int> budgets(
+            static_cast<std::size_t>(random_int(rng, 1, 3)));
+        for(int & budget : budgets) budget = random_int(rng, -5, 60);
+        const int optimum = brute_force_value(instance, budgets);
+        for(std::size_t nb_threads = 1; nb_threads <= 3; ++nb_threads) {
+            Knapsack::multiple_knapsack_bnb solver(budgets, instance.items,
+                                                   instance.value_map(),
+                                                   instance.cost_map());
+            solver.set_nb_threads(nb_threads);
+            // the threads poll their own copy of the deadline token
+            if(nb_threads == 2)
+                EXPECT_TRUE(solver.solve(std::chrono::hours(1)));
+            else
+                solver.solve();
+            std::vector<int> budgets_left = budgets;
+            std::vector<bool> taken(instance.size(), false);
+            int value = 0;
+            for(auto && [i, bin] : solver.solution()) {
+                const std::size_t j = static_cast<std::size_t>(i);
+                ASSERT_FALSE(taken[j]);
+                taken[j] = true;
+                ASSERT_LT(bin, budgets.size());
+                budgets_left[bin] -= instance.costs[j];
+                value += instance.values[j];
+                EXPECT_GE(budgets_left[bin], 0);
+            }
+            EXPECT_EQ(value, optimum);
+            EXPECT_EQ(solver.solution_value(), optimum);
+        }
+    }
+}
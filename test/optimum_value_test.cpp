@@ -1,30 +1,31 @@
 #include "gtest/gtest.h"
 
+#include <cstdint>
 #include <filesystem>
-#include <iostream>
+#include <utility>
+#include <vector>
 
-#include "knapsack/branch_and_bound.hpp"
-#include "knapsack/dynamic_programming.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/solve.hpp"
 #include "utils/instance_parsers.hpp"
 
 namespace Knapsack = fhamonic::knapsack;
-namespace UnboundedKnapsack = fhamonic::unbounded_knapsack;
 
-std::vector<std::pair<Instance<int, int>, double>> instances;
+using Item = Instance<int, int>::Item;
+
+std::vector<std::pair<Instance<int, int>, std::int64_t>> instances;
 
 class Environment : public ::testing::Environment {
 public:
     void SetUp() {
-        instances.emplace_back(parse_tp_instance("../../instances/knapsack/sac0"),
-                               103);
-        instances.emplace_back(parse_tp_instance("../../instances/knapsack/sac1"),
-                               2077672);
-        instances.emplace_back(parse_tp_instance("../../instances/knapsack/sac2"),
-                               2095878);
-        instances.emplace_back(parse_tp_instance("../../instances/knapsack/sac3"),
-                               2132531);
-        instances.emplace_back(parse_tp_instance("../../instances/knapsack/sac4"),
-                               2166542);
+        const std::filesystem::path directory =
+            std::filesystem::path(INSTANCES_DIRECTORY) / "knapsack";
+        instances.emplace_back(parse_tp_instance(directory / "sac0"), 103);
+        instances.emplace_back(parse_tp_instance(directory / "sac1"), 2077672);
+        instances.emplace_back(parse_tp_instance(directory / "sac2"), 2095878);
+        instances.emplace_back(parse_tp_instance(directory / "sac3"), 2132531);
+        instances.emplace_back(parse_tp_instance(directory / "sac4"), 2166542);
     }
 };
 
@@ -34,18 +35,41 @@ int main(int argc, char ** argv) {
     return RUN_ALL_TESTS();
 }
 
+const auto item_value = [](const Item & i) { return i.value; };
+const auto item_cost = [](const Item & i) { return i.cost; };
+
+template <typename R>
+std::int64_t solution_value(const R & solution) {
+    std::int64_t value = 0;
+    for(auto && i : solution) value += i.value;
+    return value;
+}
+
 TEST(KnapsackBNB, OptTest) {
-    Knapsack::BranchAndBound<int, int> solver;
     for(const auto & [instance, opt] : instances) {
-        Knapsack::Solution<int, int> solution = solver.solve(instance);
-        EXPECT_EQ(solution.getValue(), opt);
+        const auto items = instance.getItems();
+        auto solver = Knapsack::knapsack_bnb(instance.getBudget(), items,
+                                             item_value, item_cost);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
     }
 }
 
 TEST(KnapsackDP, OptTest) {
-    Knapsack::DynamicProgramming<int, int> solver;
     for(const auto & [instance, opt] : instances) {
-        Knapsack::Solution<int, int> solution = solver.solve(instance);
-        EXPECT_EQ(solution.getValue(), opt);
+        const auto items = instance.getItems();
+        auto solver = Knapsack::knapsack_dp(instance.getBudget(), items,
+                                            item_value, item_cost);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
+    }
+}
+
+TEST(KnapsackSolve, OptTest) {
+    for(const auto & [instance, opt] : instances) {
+        const auto items = instance.getItems();
+        EXPECT_EQ(solution_value(Knapsack::solve(instance.getBudget(), items,
+                                                 item_value, item_cost)),
+                  opt);
     }
 }
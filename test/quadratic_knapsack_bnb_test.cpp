@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "knapsack/quadratic_knapsack_bnb.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+using pair_profit = std::tuple<std::size_t, std::size_t, int>;
+
+int quadratic_value(const random_instance & instance,
+                    const std::vector<pair_profit> & pair_profits,
+                    const std::uint64_t subset) {
+    int value = subset_value(instance, subset);
+    for(auto && [i, j, profit] : pair_profits)
+        if(i != j && is_taken(subset, i) && is_taken(subset, j))
+            value += profit;
+    return value;
+}
+
+// Items of negative values, pairs of negative profits, duplicated pairs and
+// pairs of an item with itself, which are ignored
+TEST(QuadraticKnapsackBNB, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 12)));
+        for(int & value : instance.values) value -= 10;
+        std::vector<pair_profit> pair_profits;
+        if(instance.size() > 0) {
+            const int nb_pairs =
+                random_int(rng, 0, static_cast<int>(instance.size() * 2));
+            const int last = static_cast<int>(instance.size()) - 1;
+            for(int k = 0; k < nb_pairs; ++k)
+                pair_profits.emplace_back(
+                    static_cast<std::size_t>(random_int(rng, 0, last)),
+                    static_cast<std::size_t>(random_int(rng, 0, last)),
+                    random_int(rng, -20, 40));
+        }
+        int optimum = 0;
+        for_each_subset(instance, [&](const std::uint64_t subset) {
+            if(subset_cost(instance, subset) > instance.budget) return;
+            optimum = std::max(optimum,
+                               quadratic_value(instance, pair_profits, subset));
+        });
+
+        auto solver = Knapsack::quadratic_knapsack_bnb(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), pair_profits);
+        solver.solve();
+        std::uint64_t subset = 0;
+        for(auto && i : solver.solution()) {
+            ASSERT_FALSE(is_taken(subset, static_cast<std::size_t>(i)));
+            subset |= std::uint64_t{1} << i;
+        }
+        EXPECT_LE(subset_cost(instance, subset), instance.budget);
+        EXPECT_EQ(quadratic_value(instance, pair_profits, subset), optimum);
+        EXPECT_EQ(solver.solution_value(), optimum);
+    }
+}
+
+TEST(QuadraticKnapsackBNB, PositionOutOfRange) {
+    std::mt19937 rng(3);
+    const random_instance instance = make_random_instance(rng, 5);
+    const auto make_solver = [&](const std::vector<pair_profit> & profits) {
+        return Knapsack::quadratic_knapsack_bnb(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map(), profits);
+    };
+    EXPECT_NO_THROW(make_solver({{0, 4, 1}}));
+    EXPECT_THROW(make_solver({{0, 5, 1}}), std::invalid_argument);
+    EXPECT_THROW(make_solver({{5, 0, 1}}), std::invalid_argument);
+    const std::vector<std::tuple<int, int, int>> negative{{-1, 0, 1}};
+    EXPECT_THROW(Knapsack::quadratic_knapsack_bnb(
+                     instance.budget, instance.items, instance.value_map(),
+                     instance.cost_map(), negative),
+                 std::invalid_argument);
+}
@@ -0,0 +1,104 @@
+#ifndef FHAMONIC_KNAPSACK_TEST_RANDOM_INSTANCES_HPP
+#define FHAMONIC_KNAPSACK_TEST_RANDOM_INSTANCES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Small random instances, solved exactly by enumerating every subset
+struct random_instance {
+    int budget;
+    std::vector<int> values;
+    std::vector<int> costs;
+    std::vector<int> items;
+
+    std::size_t size() const noexcept { return items.size(); }
+    auto value_map() const {
+        return [this](const int i) {
+            return values[static_cast<std::size_t>(i)];
+        };
+    }
+    auto cost_map() const {
+        return [this](const int i) {
+            return costs[static_cast<std::size_t>(i)];
+        };
+    }
+};
+
+inline int random_int(std::mt19937 & rng, const int min, const int max) {
+    return std::uniform_int_distribution<int>(min, max)(rng);
+}
+
+inline random_instance make_random_instance(std::mt19937 & rng,
+                                            const std::size_t nb_items,
+                                            const int max_value = 50,
+                                            const int max_cost = 30) {
+    random_instance instance;
+    for(std::size_t i = 0; i < nb_items; ++i) {
+        instance.values.push_back(random_int(rng, 0, max_value));
+        instance.costs.push_back(random_int(rng, 0, max_cost));
+        instance.items.push_back(static_cast<int>(i));
+    }
+    int total_cost = 0;
+    for(const int cost : instance.costs) total_cost += cost;
+    instance.budget = random_int(rng, 0, total_cost);
+    return instance;
+}
+
+inline bool is_taken(const std::uint64_t subset, const std::size_t i) {
+    return ((subset >> i) & 1) != 0;
+}
+
+inline int subset_value(const random_instance & instance,
+                        const std::uint64_t subset) {
+    int value = 0;
+    for(std::size_t i = 0; i < instance.size(); ++i)
+        if(is_taken(subset, i)) value += instance.values[i];
+    return value;
+}
+
+inline int subset_cost(const random_instance & instance,
+                       const std::uint64_t subset) {
+    int cost = 0;
+    for(std::size_t i = 0; i < instance.size(); ++i)
+        if(is_taken(subset, i)) cost += instance.costs[i];
+    return cost;
+}
+
+// Calls 'f' with every subset of the items, as a bitmask
+template <typename F>
+void for_each_subset(const random_instance & instance, F && f) {
+    const std::uint64_t nb_subsets = std::uint64_t{1} << instance.size();
+    for(std::uint64_t subset = 0; subset < nb_subsets; ++subset) f(subset);
+}
+
+inline int brute_force_value(const random_instance & instance) {
+    int best_value = 0;
+    for_each_subset(instance, [&](const std::uint64_t subset) {
+        if(subset_cost(instance, subset) > instance.budget) return;
+        best_value = std::max(best_value, subset_value(instance, subset));
+    });
+    return best_value;
+}
+
+// Value of a solution given as a range of items, which must be distinct and
+// fit in 'budget'
+template <typename R>
+int checked_solution_value(const random_instance & instance, const int budget,
+                           R && solution) {
+    std::vector<bool> taken(instance.size(), false);
+    int value = 0;
+    int cost = 0;
+    for(auto && i : solution) {
+        const std::size_t j = static_cast<std::size_t>(i);
+        if(taken[j]) return -1;
+        taken[j] = true;
+        value += instance.values[j];
+        cost += instance.costs[j];
+    }
+    return (cost <= budget) ? value : -1;
+}
+
+#endif  // FHAMONIC_KNAPSACK_TEST_RANDOM_INSTANCES_HPP
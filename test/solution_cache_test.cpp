@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "knapsack/solution_cache.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// Optimum of the unbounded knapsack for positive costs
+int unbounded_optimum(const random_instance & instance) {
+    std::vector<int> best(static_cast<std::size_t>(instance.budget) + 1, 0);
+    for(std::size_t w = 1; w < best.size(); ++w) {
+        best[w] = best[w - 1];
+        for(std::size_t i = 0; i < instance.size(); ++i) {
+            const std::size_t cost =
+                static_cast<std::size_t>(instance.costs[i]);
+            if(cost <= w)
+                best[w] =
+                    std::max(best[w], best[w - cost] + instance.values[i]);
+        }
+    }
+    return best.back();
+}
+
+// The 0-1 solvers share the cache entries, so only the first of the four
+// solves of each instance, with its items in both orders, is a miss
+TEST(SolutionCache, CachedSolvers) {
+    std::mt19937 rng(1);
+    Knapsack::solution_cache<int, int> cache(std::size_t{1} << 20);
+    for(int t = 0; t < 100; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 1, 12)));
+        const int optimum = brute_force_value(instance);
+        std::vector<int> shuffled_items = instance.items;
+        std::ranges::shuffle(shuffled_items, rng);
+        for(const auto & items : {instance.items, shuffled_items}) {
+            EXPECT_EQ(checked_solution_value(
+                          instance, instance.budget,
+                          Knapsack::cached_knapsack_bnb(
+                              cache, instance.budget, items,
+                              instance.value_map(), instance.cost_map())),
+                      optimum);
+            EXPECT_EQ(checked_solution_value(
+                          instance, instance.budget,
+                          Knapsack::cached_knapsack_dp(
+                              cache, instance.budget, items,
+                              instance.value_map(), instance.cost_map())),
+                      optimum);
+        }
+    }
+    EXPECT_EQ(cache.statistics().nb_misses, 100u);
+    EXPECT_EQ(cache.statistics().nb_hits, 300u);
+}
+
+TEST(SolutionCache, CachedUnboundedSolver) {
+    std::mt19937 rng(2);
+    Knapsack::solution_cache<int, int> cache(std::size_t{1} << 20);
+    for(int t = 0; t < 100; ++t) {
+        random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 1, 8)));
+        for(int & cost : instance.costs) cost += 1;
+        instance.budget = random_int(rng, 0, 100);
+        int value = 0;
+        int cost = 0;
+        for(auto && [i, count] : Knapsack::cached_unbounded_knapsack_bnb(
+                cache, instance.budget, instance.items, instance.value_map(),
+                instance.cost_map())) {
+            const std::size_t j = static_cast<std::size_t>(i);
+            value += instance.values[j] * static_cast<int>(count);
+            cost += instance.costs[j] * static_cast<int>(count);
+        }
+        EXPECT_LE(cost, instance.budget);
+        EXPECT_EQ(value, unbounded_optimum(instance));
+    }
+}
+
+// Entries are evicted once the memory bound is exceeded
+TEST(SolutionCache, Eviction) {
+    std::mt19937 rng(3);
+    Knapsack::solution_cache<int, int> cache(0);
+    const random_instance instance = make_random_instance(rng, 10);
+    for(int t = 0; t < 2; ++t)
+        EXPECT_EQ(checked_solution_value(
+                      instance, instance.budget,
+                      Knapsack::cached_knapsack_bnb(
+                          cache, instance.budget, instance.items,
+                          instance.value_map(), instance.cost_map())),
+                  brute_force_value(instance));
+    EXPECT_EQ(cache.statistics().nb_hits, 0u);
+    EXPECT_EQ(cache.statistics().memory_used, 0u);
+}
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "knapsack/fixed_point.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/solve.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+TEST(Solve, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        EXPECT_EQ(checked_solution_value(
+                      instance, instance.budget,
+                      Knapsack::solve(instance.budget, instance.items,
+                                      instance.value_map(),
+                                      instance.cost_map())),
+                  brute_force_value(instance));
+    }
+}
+
+// (nb_items + 1) * (budget + 1) wraps around to 0 cells, the table would be
+// far too large for the dynamic program
+TEST(Solve, TableSizeOverflow) {
+    constexpr std::int64_t cost = (std::int64_t{1} << 52) +
+                                  (std::int64_t{1} << 47);
+    constexpr std::int64_t budget = (std::int64_t{1} << 58) - 1;
+    std::mt19937 rng(2);
+    std::vector<std::int64_t> values;
+    std::vector<std::int64_t> costs;
+    for(int i = 0; i < 63; ++i) {
+        values.push_back(random_int(rng, 1, 1000));
+        costs.push_back(cost + i);
+    }
+    std::vector<std::size_t> items(values.size());
+    std::iota(items.begin(), items.end(), std::size_t{0});
+    const auto value_map = [&](const std::size_t i) { return values[i]; };
+    const auto cost_map = [&](const std::size_t i) { return costs[i]; };
+    EXPECT_EQ(Knapsack::select_solver(budget, items, value_map, cost_map),
+              Knapsack::solver_kind::branch_and_bound);
+
+    auto bnb = Knapsack::knapsack_bnb(budget, items, value_map, cost_map);
+    bnb.solve();
+    std::int64_t solution_value = 0;
+    std::int64_t solution_cost = 0;
+    for(const std::size_t i : Knapsack::solve(budget, items, value_map,
+                                              cost_map)) {
+        solution_value += values[i];
+        solution_cost += costs[i];
+    }
+    EXPECT_LE(solution_cost, budget);
+    EXPECT_EQ(solution_value,
+              static_cast<std::int64_t>(bnb.solution_value()));
+}
+
+// Budgets whose scaled value exceeds std::int64_t saturate, every item fits
+TEST(Solve, HugeFloatingPointBudget) {
+    EXPECT_EQ(Knapsack::to_fixed_point_floor(1e300, 100),
+              std::numeric_limits<std::int64_t>::max());
+    EXPECT_EQ(Knapsack::to_fixed_point_floor(-1e300, 100),
+              std::numeric_limits<std::int64_t>::min());
+    EXPECT_EQ(Knapsack::to_fixed_point_floor(2.5, 100), 250);
+
+    const std::vector<double> values{1.5, 2.25, 0.75};
+    const std::vector<double> costs{0.5, 1.25, 2.75};
+    const std::vector<std::size_t> items{0, 1, 2};
+    const auto value_map = [&](const std::size_t i) { return values[i]; };
+    const auto cost_map = [&](const std::size_t i) { return costs[i]; };
+    for(const double budget : {1e30, 1e300,
+                               std::numeric_limits<double>::infinity()})
+        EXPECT_EQ(Knapsack::solve(budget, items, value_map, cost_map).size(),
+                  3u);
+}
+
+TEST(Solve, DecimalScale) {
+    EXPECT_EQ(Knapsack::decimal_scale(std::vector<double>{1, 2, 30}), 1);
+    EXPECT_EQ(Knapsack::decimal_scale(std::vector<double>{0.1, 0.2, 3}), 10);
+    EXPECT_EQ(Knapsack::decimal_scale(std::vector<double>{0.5, 1.25}), 100);
+    EXPECT_EQ(Knapsack::decimal_scale(std::vector<double>{1.0 / 3}), 0);
+    EXPECT_EQ(Knapsack::decimal_scale(std::vector<double>{0.1234567}), 0);
+    EXPECT_EQ(Knapsack::decimal_scale(std::vector<double>{1e17}), 0);
+    EXPECT_EQ(Knapsack::to_fixed_point(0.29, 100), 29);
+    EXPECT_EQ(Knapsack::to_fixed_point_floor(0.29, 100), 29);
+    EXPECT_EQ(Knapsack::to_fixed_point_floor(0.299, 100), 29);
+}
+
+// Values and costs with two decimals are solved exactly on integers, 0.29
+// times 100 is not exactly 29 in double
+TEST(Solve, DecimalInstances) {
+    std::mt19937 rng(3);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)), 5000,
+            3000);
+        std::vector<double> values;
+        std::vector<double> costs;
+        for(std::size_t i = 0; i < instance.size(); ++i) {
+            values.push_back(instance.values[i] / 100.0);
+            costs.push_back(instance.costs[i] / 100.0);
+        }
+        const auto solution = Knapsack::solve(
+            instance.budget / 100.0, instance.items,
+            [&](const int i) { return values[static_cast<std::size_t>(i)]; },
+            [&](const int i) { return costs[static_cast<std::size_t>(i)]; });
+        EXPECT_EQ(checked_solution_value(instance, instance.budget, solution),
+                  brute_force_value(instance));
+    }
+}
+
+// Values of a third have no decimal scale, the instance is solved by the
+// branch and bound on doubles, whose bounds are rounded up by their rounding
+// error
+TEST(Solve, NonDecimalInstances) {
+    std::mt19937 rng(4);
+    for(int t = 0; t < 300; ++t) {
+        random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 1, 14)));
+        std::vector<double> values;
+        std::vector<double> costs;
+        for(std::size_t i = 0; i < instance.size(); ++i) {
+            values.push_back(instance.values[i] + 1.0 / 3);
+            costs.push_back(instance.costs[i]);
+        }
+        ASSERT_EQ(Knapsack::decimal_scale(values), 0);
+        const auto solution = Knapsack::solve(
+            static_cast<double>(instance.budget), instance.items,
+            [&](const int i) { return values[static_cast<std::size_t>(i)]; },
+            [&](const int i) { return costs[static_cast<std::size_t>(i)]; });
+        // values scaled by 3 to compare on integers
+        for(int & value : instance.values) value = 3 * value + 1;
+        EXPECT_EQ(checked_solution_value(instance, instance.budget, solution),
+                  brute_force_value(instance));
+    }
+}
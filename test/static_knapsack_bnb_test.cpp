@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "knapsack/static_knapsack_bnb.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// f1_l-d_kp_10_269 of the low dimensional instances
+constexpr int low_dimensional_optimum() {
+    constexpr std::array<std::pair<int, int>, 10> items{
+        {{55, 95}, {10, 4}, {47, 60}, {5, 32}, {4, 23},
+         {50, 72}, {8, 80}, {61, 62}, {85, 65}, {87, 46}}};
+    auto solver = Knapsack::make_static_knapsack_bnb<10>(
+        269, items, &std::pair<int, int>::first, &std::pair<int, int>::second);
+    solver.solve();
+    int value = 0;
+    for(const std::size_t i : solver.solution()) value += items[i].first;
+    return value;
+}
+static_assert(low_dimensional_optimum() == 295);
+
+TEST(StaticKnapsackBNB, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 16)));
+        auto solver = Knapsack::make_static_knapsack_bnb<16>(
+            instance.budget, instance.items, instance.value_map(),
+            instance.cost_map());
+        solver.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  brute_force_value(instance));
+    }
+}
+
+TEST(StaticKnapsackBNB, TooManyItems) {
+    const std::vector<std::pair<int, int>> items(5, {1, 1});
+    EXPECT_NO_THROW(Knapsack::make_static_knapsack_bnb<5>(
+        3, items, &std::pair<int, int>::first, &std::pair<int, int>::second));
+    EXPECT_THROW(Knapsack::make_static_knapsack_bnb<4>(
+                     3, items, &std::pair<int, int>::first,
+                     &std::pair<int, int>::second),
+                 std::invalid_argument);
+}
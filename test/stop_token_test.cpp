@@ -0,0 +1,54 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/stop_token.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// The clock is read once every check_period polls
+TEST(DeadlineStopToken, Expiration) {
+    const Knapsack::deadline_stop_token expired(
+        std::chrono::steady_clock::now());
+    std::uint32_t nb_polls = 1;
+    while(!expired.stop_requested()) ++nb_polls;
+    EXPECT_EQ(nb_polls, Knapsack::deadline_stop_token::check_period);
+    EXPECT_TRUE(expired.stop_requested());
+
+    const Knapsack::deadline_stop_token far(std::chrono::hours(1));
+    const Knapsack::deadline_stop_token never(std::chrono::duration<double>(
+        std::numeric_limits<double>::max()));
+    EXPECT_EQ(never.deadline(), std::chrono::steady_clock::time_point::max());
+    constexpr std::uint32_t nb_polls_max =
+        4 * Knapsack::deadline_stop_token::check_period;
+    for(std::uint32_t i = 0; i < nb_polls_max; ++i) {
+        EXPECT_FALSE(far.stop_requested());
+        EXPECT_FALSE(never.stop_requested());
+    }
+}
+
+TEST(DeadlineStopToken, KnapsackBnB) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 100; ++t) {
+        const random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)));
+        auto solver = Knapsack::knapsack_bnb(instance.budget, instance.items,
+                                             instance.value_map(),
+                                             instance.cost_map());
+        EXPECT_TRUE(solver.solve(Knapsack::deadline_stop_token(
+            std::chrono::hours(1))));
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  brute_force_value(instance));
+        EXPECT_TRUE(solver.solve(std::chrono::hours(1)));
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  brute_force_value(instance));
+    }
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+
+#include <random>
+
+#include "knapsack/subset_sum_dp.hpp"
+
+#include "random_instances.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+// Costs larger than a word of the bitset so that shifts cross words
+TEST(SubsetSumDP, BruteForce) {
+    std::mt19937 rng(1);
+    for(int t = 0; t < 300; ++t) {
+        random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 0, 14)), 0, 200);
+        instance.values = instance.costs;
+        auto solver = Knapsack::subset_sum_dp(instance.budget, instance.items,
+                                              instance.cost_map());
+        solver.solve();
+        const int optimum = brute_force_value(instance);
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  optimum);
+        EXPECT_EQ(solver.solution_value(), optimum);
+    }
+}
+
+// Costs of common divisor 3, that the budget and costs are divided by
+TEST(SubsetSumDP, CommonDivisor) {
+    std::mt19937 rng(2);
+    for(int t = 0; t < 100; ++t) {
+        random_instance instance = make_random_instance(
+            rng, static_cast<std::size_t>(random_int(rng, 1, 12)), 0, 60);
+        for(int & cost : instance.costs) cost *= 3;
+        instance.values = instance.costs;
+        instance.budget = random_int(rng, 0, 1000);
+        auto solver = Knapsack::subset_sum_dp(instance.budget, instance.items,
+                                              instance.cost_map());
+        solver.solve();
+        EXPECT_EQ(checked_solution_value(instance, instance.budget,
+                                         solver.solution()),
+                  brute_force_value(instance));
+    }
+}